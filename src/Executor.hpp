@@ -3,11 +3,20 @@
 #include <EWrapperAdapter.hpp>
 
 #include <Shell.hpp>
+#include <Headless.hpp>
 #include <Portfolio.hpp>
+#include <ShardedLedger.hpp>
 #include <DBI.hpp>
 #include <BTester.hpp>
+#include <CoMoments.hpp>
+#include <DataParallel.hpp>
+#include <Integrity.hpp>
+#include <MergedFeed.hpp>
+#include <CallbackJournal.hpp>
+#include <MockTws.hpp>
 
 class IStrategy;
+class StrategySet;
 enum class StrategyType;
 
 class Executor final : public EWrapperAdapter {
@@ -15,7 +24,9 @@ public:
     explicit Executor();
     ~Executor() override;
 
-    static void fitRun(int epochs = 10, int batchSize = 64, float lr = 1e-4);
+    static void fitRun(int epochs = 10, int batchSize = 64, float lr = 1e-4,
+                       int replicas = 1, bool deterministic = true);
+    static void benchFit(int maxThreads = 32, int steps = 20, int batchSize = 256);
 
     // Setup
     bool Setup();
@@ -31,10 +42,20 @@ public:
 
     // Core Components
     DBI dbI;
+#ifdef IBAT_HEADLESS
+    HeadlessShell terminal;
+#else
     ImGuiTerminalShell terminal;
+#endif
     std::shared_ptr<BTester> tester = nullptr;
     std::shared_ptr<IStrategy> strat = nullptr;
+    //? Additional strategies run on the same feed as strat, sharing SHARED_INDICATOR state.
+    std::shared_ptr<StrategySet> Strategies = nullptr;
+    void addStrategy(StrategyType type);
     Portfolio Port;
+    //? Lock-free entry/exit book. The shard count only spreads pnl contention, it is fixed for the executor's life.
+    //? Built before symbols load, Reset() sizes it to the seeded universe.
+    ShardedLedger Ledger{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
     double backtestBal = 1000;
     bool EOD = false;
 
@@ -52,7 +73,7 @@ public:
     // Threading and synchronization
     std::vector<std::thread> threads;
     std::queue<std::pair<int,Bar>> dataQueue;
-    std::mutex enterTex;
+    std::mutex enterTex; //! Only guards Port bookkeeping not covered by Ledger
     std::mutex m_mutex;
     std::mutex dataEndMutex;
     std::mutex logtex;
@@ -65,10 +86,19 @@ public:
     bool historicalDataWritten = false;
 
     void Start(bool eval);
+    //? Loads the latest end-of-day snapshot and replays only newer bars, optionally checked against a full replay.
+    bool WarmStart(const std::string &snapshot, bool verify = false);
+    void SaveSnapshot(const std::string &snapshot) const;
     void DayEnd() noexcept;
 
     void Evaluate(bool eval = false, bool noLog = false);
+    //? Event-driven backtest: per-symbol block streams merged into one time-ordered feed, bounded memory.
+    void EvaluateMerged(bool eval = false, int blockBars = 4096);
     void backTestViz(int sym, long startTime = 0, bool eval = false);
+    //? Bootstrap / Monte Carlo confidence intervals over the last run's trades (method 0 iid, 1 block, 2 shuffle).
+    void monteCarlo(int resamples = 20000, int method = 1) const;
+    //? Walk-forward study with windows in days, per-window METRIC results written to walkforward.csv.
+    void walkForward(int trainDays = 250, int testDays = 20, int stepDays = 0);
 
     void updateTensors();
     void generateTensors(bool eval = false);
@@ -85,12 +115,43 @@ public:
     void updateAllHistoricalData(bool sort = false, bool verify = false);
     void recHistoricalDataForUpdate();
     void updateParquets() const;
-    void verifyDataIntegrity();
+
+    // * Universe *
+    //? Runtime universe changes, new symbols are backfilled and warmed in the background before going active.
+    void addSymbol(const std::string &name);
+    void removeSymbol(const std::string &name);
+
+    // * Callback journal *
+    //? While set, tickPrice/historicalData/historicalDataEnd/error append to the journal before handling.
+    //? Callbacks take their own reference with Recorder.load(), stopRecording only stores nullptr, so a
+    //? callback in flight keeps the recorder alive and the last reference flushes and closes the journal.
+    std::atomic<std::shared_ptr<CallbackRecorder>> Recorder;
+    void recordFeed(const std::string &path);
+    void stopRecording();
+    //? Feeds a recorded journal through this executor's callbacks, speed 1 real time, <= 0 max speed.
+    void replayFeed(const std::string &path, double speed = 0);
+
+    // * Mock TWS *
+    //? When set, reqBars and market data requests go to the mock instead of client.
+    std::unique_ptr<MockTws> Mock = nullptr;
+    MockTwsConfig mockCfg;
+    //? Peak-open load test against the mock: ingestion throughput, dataQueue depth and tick-to-signal latency.
+    void loadTest(int symbols = 2000, double ticksPerSecond = 5, double seconds = 30);
+
+    // * Data integrity *
+    void verifyDataIntegrity(bool repair = false);
+    IntegrityConfig integrityCfg;
+    std::vector<RepairRequest> RepairQueue;
 
     // * Feature validation *
+    //? Streamed in one pass over the dataset by NUM_VALIDATORS workers, results cached per DatasetVersion().
     void showCollCorr(int64_t Label = 0, bool eval = false, int batch = 0) const;
     void showAutoCorr(int64_t Feat = 0, bool eval = false, int batch = 0) const;
-    void validateFeatsRidge(int64_t Label = 0) const;
+    void validateFeatsRidge(int64_t Label = 0, double lambda = 1.0) const;
+    [[nodiscard]] std::string DatasetVersion() const;
+
+    unsigned NUM_VALIDATORS = std::thread::hardware_concurrency();
+    ValidationCache validationCache{"cache/validation"};
 
 private:
     // * EWrapper interface *
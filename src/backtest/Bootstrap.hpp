@@ -0,0 +1,194 @@
+#pragma once
+
+#include <BOT.hpp>
+#include <Jobs.hpp>
+
+//? One closed trade as recorded by the strategy, pnl is gross of slippage and commission.
+struct TradeRecord {
+    int Sym;
+    int64_t EntryTime;
+    int64_t ExitTime;
+    double EntryPrice;
+    double ExitPrice;
+    double Qty;
+    bool Short;
+
+    [[nodiscard]] double Gross() const {return (ExitPrice - EntryPrice) * Qty * (Short ? -1.0 : 1.0);}
+};
+
+enum class Resample {
+    Bootstrap,      // iid draws with replacement
+    Block,          // moving block bootstrap, keeps short-range dependence
+    Shuffle         // permutation of the recorded order, only path metrics change
+};
+
+struct MonteCarloConfig {
+    int Resamples = 20000;
+    Resample Method = Resample::Block;
+    int BlockLength = 10;
+    bool RandomCosts = true;
+    double Slippage = 0.05;         // Per share per side, as IStrategy::slippage
+    double Commission = 0.35;       // Per side, as IStrategy::commission
+    double CostJitter = 0.5;        // Costs drawn uniformly in [1 - j, 1 + j] x nominal
+    double StartBalance = 1000;
+    uint64_t Seed = 0x1BA7;
+    unsigned Threads = std::thread::hardware_concurrency();
+};
+
+struct Distribution {
+    double Mean = 0;
+    double P05 = 0;
+    double P50 = 0;
+    double P95 = 0;
+
+    static Distribution Of(std::vector<double> &v) {
+        Distribution d;
+        if (v.empty()) return d;
+        d.Mean = std::accumulate(v.begin(), v.end(), 0.0) / static_cast<double>(v.size());
+        const auto q = [&v](const double p) {
+            const auto k = static_cast<size_t>(p * static_cast<double>(v.size() - 1));
+            std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+            return v[k];
+        };
+        d.P05 = q(0.05);
+        d.P50 = q(0.50);
+        d.P95 = q(0.95);
+        return d;
+    }
+};
+
+struct MonteCarloResult {
+    Distribution Profit;
+    Distribution MaxDrawdown;       // Fraction of peak equity
+    Distribution WinRate;
+    double ProbLoss = 0;
+    int Resamples = 0;
+
+    void Print() const {
+        auto out = ibat::sout;
+        const auto row = [&out](const char* name, const Distribution &d) {
+            out << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(4)
+                << " mean " << std::setw(12) << d.Mean << "  5% " << std::setw(12) << d.P05
+                << "  50% " << std::setw(12) << d.P50 << "  95% " << std::setw(12) << d.P95 << std::endl;
+        };
+        out << GREEN << "Monte Carlo over " << Resamples << " resamples" << RES << std::endl;
+        row("Profit", Profit);
+        row("MaxDrawdown", MaxDrawdown);
+        row("WinRate", WinRate);
+        out << "P(loss) " << std::setprecision(4) << ProbLoss << std::endl;
+    }
+};
+
+//? Resamples the recorded trade sequence across threads. Every resample draws from its own generator
+//? seeded by its index, so results do not depend on the thread count.
+//? Workers stop at the next chunk once cancel is set and the call throws JobCancelled.
+inline MonteCarloResult MonteCarlo(const std::vector<TradeRecord> &trades, const MonteCarloConfig &cfg = {},
+                                   const CancelToken &cancel = job::Token()) {
+    MonteCarloResult res;
+    res.Resamples = cfg.Resamples;
+    const size_t n = trades.size();
+    if (n == 0 || cfg.Resamples <= 0) return res;
+
+    std::vector<double> gross(n), qty(n);
+    for (size_t i = 0; i < n; ++i) {
+        gross[i] = trades[i].Gross();
+        qty[i] = std::abs(trades[i].Qty);
+    }
+
+    std::vector<double> profit(cfg.Resamples), drawdown(cfg.Resamples), winRate(cfg.Resamples);
+    std::atomic<int> next{0};
+    //? Lanes resamples are walked side by side, pnl is stored [trade][lane] so the equity recurrence runs
+    //? across lanes in SIMD registers. Each lane still draws from its own per-index generator.
+    constexpr int Lanes = 8;
+    constexpr int Chunk = 64;
+    static_assert(Chunk % Lanes == 0);
+
+    const auto worker = [&] {
+        std::vector<double> pnl(n * Lanes);
+        std::vector<size_t> order(n);
+        for (int base = next.fetch_add(Chunk); base < cfg.Resamples; base = next.fetch_add(Chunk)) {
+            if (cancel.Cancelled()) return;
+            const int end = std::min(base + Chunk, cfg.Resamples);
+            for (int r0 = base; r0 < end; r0 += Lanes) {
+                const int lanes = std::min(Lanes, end - r0);
+                for (int l = 0; l < Lanes; ++l) {
+                    if (l >= lanes) {
+                        for (size_t i = 0; i < n; ++i) pnl[i * Lanes + l] = 0;
+                        continue;
+                    }
+                    std::mt19937_64 rng(cfg.Seed ^ (0x9e3779b97f4a7c15ull * (static_cast<uint64_t>(r0 + l) + 1)));
+                    std::uniform_int_distribution<size_t> pick(0, n - 1);
+
+                    switch (cfg.Method) {
+                        case Resample::Bootstrap:
+                            for (auto &o : order) o = pick(rng);
+                            break;
+                        case Resample::Block: {
+                            const size_t len = std::clamp<size_t>(cfg.BlockLength, 1, n);
+                            std::uniform_int_distribution<size_t> startPick(0, n - len);
+                            for (size_t i = 0; i < n;) {
+                                const size_t s = startPick(rng);
+                                for (size_t k = 0; k < len && i < n; ++k) order[i++] = s + k;
+                            }
+                            break;
+                        }
+                        case Resample::Shuffle:
+                            std::iota(order.begin(), order.end(), 0);
+                            std::ranges::shuffle(order, rng);
+                            break;
+                    }
+
+                    const double slip = 2.0 * cfg.Slippage, comm = 2.0 * cfg.Commission;
+                    if (cfg.RandomCosts) {
+                        std::uniform_real_distribution<double> jitter(1.0 - cfg.CostJitter, 1.0 + cfg.CostJitter);
+                        for (size_t i = 0; i < n; ++i)
+                            pnl[i * Lanes + l] = gross[order[i]] - (slip * qty[order[i]] + comm) * jitter(rng);
+                    } else {
+                        for (size_t i = 0; i < n; ++i)
+                            pnl[i * Lanes + l] = gross[order[i]] - (slip * qty[order[i]] + comm);
+                    }
+                }
+
+                //? Equity paths: running peak and worst drawdown of every lane in one pass. A positive start
+                //? balance bounds the peak away from zero, which keeps the lane loop free of branches.
+                std::array<double, Lanes> equity, peak, worst{}, wins{};
+                equity.fill(cfg.StartBalance);
+                peak.fill(cfg.StartBalance);
+                const auto walk = [&]<bool Guard>() {
+                    for (size_t i = 0; i < n; ++i) {
+                        for (int l = 0; l < Lanes; ++l) {
+                            const double x = pnl[i * Lanes + l];
+                            const double e = equity[l] + x;
+                            equity[l] = e;
+                            wins[l] += x > 0 ? 1.0 : 0.0;
+                            const double pk = std::max(peak[l], e);
+                            peak[l] = pk;
+                            if constexpr (Guard) worst[l] = std::max(worst[l], pk > 0 ? (pk - e) / pk : 0.0);
+                            else worst[l] = std::max(worst[l], (pk - e) / pk);
+                        }
+                    }
+                };
+                if (cfg.StartBalance > 0) walk.template operator()<false>();
+                else walk.template operator()<true>();
+                for (int l = 0; l < lanes; ++l) {
+                    profit[r0 + l] = equity[l] - cfg.StartBalance;
+                    drawdown[r0 + l] = worst[l];
+                    winRate[r0 + l] = wins[l] / static_cast<double>(n);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < std::max(1u, cfg.Threads); ++t) threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads) t.join();
+    cancel.Check();
+
+    res.ProbLoss = static_cast<double>(std::ranges::count_if(profit, [](const double p) {return p < 0;}))
+                   / static_cast<double>(profit.size());
+    res.Profit = Distribution::Of(profit);
+    res.MaxDrawdown = Distribution::Of(drawdown);
+    res.WinRate = Distribution::Of(winRate);
+    return res;
+}
\ No newline at end of file
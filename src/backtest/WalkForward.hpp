@@ -0,0 +1,149 @@
+#pragma once
+
+#include <IStrategy.hpp>
+#include <Portfolio.hpp>
+
+struct WalkWindow {
+    int64_t TrainStart;
+    int64_t TestStart;
+    int64_t TestEnd;
+};
+
+struct WindowResult {
+    WalkWindow Window;
+    std::vector<std::pair<std::string, double>> Metrics;
+};
+
+//? Walk-forward study over a single warmed strategy state.
+//? The main strategy is replayed through the timeline exactly once. At each window boundary its state is
+//? forked in memory (SaveState/LoadState), the fork is optionally fitted, its METRIC members are reset and
+//? it is evaluated over the test window on a worker thread while the main state keeps advancing.
+//? Total work is history + windows x test length instead of windows x history.
+//? A fork carries the open positions (SaveState) and gets its own copy of the main Portfolio and ShardedLedger,
+//? so it starts from the main state's book, not flat, and its trades never reach the main one. Its day end
+//? callback and sync barrier are detached from the global BOT.
+//! Replay may still reach process-wide state (BOT, data caches). Unless ConcurrentReplay is set, replay calls of
+//! the main state and all forks are serialized, so only fitting overlaps.
+class WalkForward {
+public:
+    using Factory = std::function<std::shared_ptr<IStrategy>()>;
+    //? Feeds bars with time in [from, to) to the strategy, e.g. through ProcessBar per symbol.
+    using Replay = std::function<void(IStrategy &strat, int64_t from, int64_t to)>;
+    //? Optional per-window fitting on the forked state before evaluation.
+    using Fit = std::function<void(IStrategy &strat, const WalkWindow &w)>;
+
+    /// @param make Builds an uninitialized strategy of the studied type.
+    /// @param train Length of the training span preceding each test window.
+    /// @param test Length of each test window.
+    /// @param step Distance between consecutive test windows, defaults to test (non-overlapping).
+    WalkForward(Factory make, const int64_t train, const int64_t test, const int64_t step = 0)
+        : make(std::move(make)), Train(train), Test(test), Step(step > 0 ? step : test) {}
+
+    const int64_t Train;
+    const int64_t Test;
+    const int64_t Step;
+    unsigned MaxConcurrent = std::max(1u, std::thread::hardware_concurrency() / 2);
+    //? Set when the replay callback only touches the strategy it is given, lets forks replay in parallel.
+    bool ConcurrentReplay = false;
+
+    [[nodiscard]] std::vector<WalkWindow> Windows(const int64_t start, const int64_t end) const {
+        std::vector<WalkWindow> out;
+        for (int64_t t = start + Train; t + Test <= end; t += Step)
+            out.push_back({t - Train, t, t + Test});
+        return out;
+    }
+
+    //? Cancelling stops before the next window's replay or fork and throws JobCancelled once running forks end.
+    std::vector<WindowResult> Run(const int64_t start, const int64_t end, const Replay &replay, const Fit &fit = nullptr,
+                                  const CancelToken &cancel = job::Token()) {
+        const auto windows = Windows(start, end);
+        std::vector<WindowResult> results(windows.size());
+        std::deque<std::future<void>> running;
+
+        const auto main = make();
+        int64_t cursor = start;
+        for (size_t i = 0; i < windows.size() && !cancel.Cancelled(); ++i) {
+            const WalkWindow &w = windows[i];
+            runReplay(replay, *main, cursor, w.TestStart);
+            cursor = w.TestStart;
+
+            std::shared_ptr<IStrategy> fork = Fork(*main);
+            while (running.size() >= MaxConcurrent) {
+                running.front().get();
+                running.pop_front();
+            }
+            running.push_back(std::async(std::launch::async, [&, fork, i] {
+                if (cancel.Cancelled()) return;
+                if (fit) fit(*fork, windows[i]);
+                for (auto *m : fork->Metrics()) m->ResetAll();
+                runReplay(replay, *fork, windows[i].TestStart, windows[i].TestEnd);
+                results[i] = {windows[i], Collect(*fork)};
+            }));
+        }
+        for (auto &f : running) f.get();
+        cancel.Check();
+        return results;
+    }
+
+    //& Copy of the strategy's full state in a fresh instance, with a private portfolio and ledger.
+    //& The returned pointer owns the copies, they live as long as the fork.
+    [[nodiscard]] std::shared_ptr<IStrategy> Fork(const IStrategy &src) const {
+        BinWriter w;
+        src.SaveState(w);
+        auto st = std::make_shared<Forked>();
+        st->strat = make();
+        BinReader r(std::vector<char>(w.Buffer()));
+        st->strat->LoadState(r);
+
+        IStrategy &f = *st->strat;
+        if (src.Port) {
+            st->port = std::make_unique<Portfolio>(*src.Port);
+            f.Port = st->port.get();
+        }
+        if (src.Ledger) {
+            st->ledger = src.Ledger->Fork();
+            f.Ledger = st->ledger.get();
+        }
+        f.backtest = src.backtest;
+        f.Synchronize = false;
+        f.SyncPoint = nullptr;
+        f.callback = []() noexcept {};
+        return {st, st->strat.get()};
+    }
+
+    //& Universe totals of every METRIC member.
+    static std::vector<std::pair<std::string, double>> Collect(IStrategy &strat) {
+        std::vector<std::pair<std::string, double>> out;
+        for (const auto *m : strat.Metrics()) out.emplace_back(m->Name(), m->Sum());
+        return out;
+    }
+
+    static void WriteCsv(const std::string &file, const std::vector<WindowResult> &results) {
+        std::ofstream out(file);
+        if (results.empty()) return;
+        out << "train_start,test_start,test_end";
+        for (const auto &[name, v] : results.front().Metrics) out << "," << name;
+        out << "\n";
+        for (const auto &r : results) {
+            out << r.Window.TrainStart << "," << r.Window.TestStart << "," << r.Window.TestEnd;
+            for (const auto &[name, v] : r.Metrics) out << "," << v;
+            out << "\n";
+        }
+    }
+
+private:
+    struct Forked {
+        std::unique_ptr<Portfolio> port;
+        std::unique_ptr<ShardedLedger> ledger;
+        std::shared_ptr<IStrategy> strat; // Last, destroyed before the book it points into
+    };
+
+    void runReplay(const Replay &replay, IStrategy &strat, const int64_t from, const int64_t to) {
+        if (ConcurrentReplay) {replay(strat, from, to); return;}
+        std::lock_guard lock(replayTex);
+        replay(strat, from, to);
+    }
+
+    Factory make;
+    std::mutex replayTex;
+};
\ No newline at end of file
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <EWrapper.h>
+#include <Serial.hpp>
+#include <AsyncLog.hpp>
+
+//? Compact binary journal of the live EWrapper callback stream.
+//? Every record is framed by length and checksum and stamped with nanoseconds since the recording started,
+//? so a torn tail is ignored and the stream can be replayed with its original timing.
+namespace journal {
+    enum class Kind : uint8_t {TickPrice = 1, HistoricalData, HistoricalDataEnd, Error};
+
+    struct FileHeader {
+        static constexpr uint32_t Magic = 0x4a524249; // "IBRJ"
+        static constexpr uint16_t Version = 1;
+
+        uint32_t magic = Magic;
+        uint16_t version = Version;
+        uint16_t flags = 0;
+        int64_t startEpochNs = 0;
+    };
+
+    struct Frame {
+        uint32_t length = 0;  // Payload bytes after the frame
+        uint32_t checksum = 0;
+        int64_t offsetNs = 0;
+        Kind kind{};
+        uint8_t reserved[7]{};
+    };
+
+    inline uint32_t Check(const char* p, const size_t n) {
+        Checksum64 sum;
+        sum.update(p, n);
+        return static_cast<uint32_t>(sum.digest());
+    }
+}
+
+class CallbackRecorder {
+public:
+    explicit CallbackRecorder(const std::string &path, const size_t flushBytes = 1 << 16)
+        : out(path, std::ios::binary | std::ios::trunc), flushBytes(flushBytes) {
+        if (!out) throw std::runtime_error("CallbackRecorder: cannot open " + path);
+        journal::FileHeader h;
+        h.startEpochNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~CallbackRecorder() {Flush();}
+
+    void TickPrice(const TickerId id, const TickType field, const double price, const TickAttrib &attrib) {
+        BinWriter &w = scratch();
+        w.val(static_cast<int64_t>(id));
+        w.val(static_cast<int32_t>(field));
+        w.val(price);
+        w.val(static_cast<uint8_t>(attrib.canAutoExecute | attrib.pastLimit << 1 | attrib.preOpen << 2));
+        commit(journal::Kind::TickPrice, w);
+    }
+
+    void HistoricalData(const TickerId reqId, const Bar &bar) {
+        BinWriter &w = scratch();
+        w.val(static_cast<int64_t>(reqId));
+        w.str(bar.time);
+        w.val(bar.high);
+        w.val(bar.low);
+        w.val(bar.open);
+        w.val(bar.close);
+        w.val(bar.wap);
+        w.val(bar.volume);
+        w.val(bar.count);
+        commit(journal::Kind::HistoricalData, w);
+    }
+
+    void HistoricalDataEnd(const int reqId, const std::string &startDate, const std::string &endDate) {
+        BinWriter &w = scratch();
+        w.val(reqId);
+        w.str(startDate);
+        w.str(endDate);
+        commit(journal::Kind::HistoricalDataEnd, w);
+    }
+
+    void Error(const int id, const time_t errorTime, const int code, const std::string &msg, const std::string &json) {
+        BinWriter &w = scratch();
+        w.val(id);
+        w.val(static_cast<int64_t>(errorTime));
+        w.val(code);
+        w.writeValue(msg);
+        w.writeValue(json);
+        commit(journal::Kind::Error, w);
+    }
+
+    void Flush() {
+        std::lock_guard lock(mtx);
+        flushLocked();
+    }
+
+    [[nodiscard]] uint64_t Records() const {return records.load(std::memory_order_relaxed);}
+
+private:
+    //? Per-thread encode buffer, callbacks never nest on one thread so it is free again by the next call.
+    static BinWriter &scratch() {
+        thread_local BinWriter w;
+        w.Clear();
+        return w;
+    }
+
+    //? Callbacks come from the reader thread and occasionally from the client thread (errors), hence the lock.
+    void commit(const journal::Kind kind, const BinWriter &w) {
+        const auto &buf = w.Buffer();
+        journal::Frame f{static_cast<uint32_t>(buf.size()), journal::Check(buf.data(), buf.size()), 0, kind};
+        const auto* fp = reinterpret_cast<const char*>(&f);
+
+        std::lock_guard lock(mtx);
+        f.offsetNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        pending.insert(pending.end(), fp, fp + sizeof(f));
+        pending.insert(pending.end(), buf.begin(), buf.end());
+        records.fetch_add(1, std::memory_order_relaxed);
+        if (pending.size() >= flushBytes) flushLocked();
+    }
+
+    void flushLocked() {
+        if (pending.empty()) return;
+        out.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+        out.flush();
+        pending.clear();
+    }
+
+    std::ofstream out;
+    std::mutex mtx;
+    std::vector<char> pending;
+    size_t flushBytes;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<uint64_t> records{0};
+};
+
+struct ReplayStats {
+    uint64_t Records = 0;
+    uint64_t Ticks = 0;
+    uint64_t Bars = 0;
+    uint64_t Ends = 0;
+    uint64_t Errors = 0;
+    double WallSeconds = 0;
+    double RecordedSeconds = 0;
+    double MaxLagUs = 0;  // Worst delay behind the scaled schedule, time spent inside the callbacks shows up here
+    bool Torn = false;    // Stopped at a damaged or truncated record
+
+    void Print() const {
+        auto out = ibat::sout;
+        out << PURPLE << "Replay " << RES << Records << " records (" << Ticks << " ticks, " << Bars << " bars, "
+            << Ends << " ends, " << Errors << " errors) in " << WallSeconds << "s, recorded span "
+            << RecordedSeconds << "s, " << static_cast<double>(Records) / std::max(WallSeconds, 1e-9)
+            << " rec/s, max lag " << MaxLagUs << "us" << (Torn ? YELLOW + std::string(" (torn tail)") + RES : "")
+            << std::endl;
+    }
+};
+
+//& Feeds a journal back into a wrapper, speed 1 is real time, >1 faster, <= 0 as fast as possible.
+inline ReplayStats ReplayCallbacks(const std::string &path, EWrapper &wrapper, const double speed = 0) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw std::runtime_error("ReplayCallbacks: cannot open " + path);
+    uint64_t remaining = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    journal::FileHeader h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)) || h.magic != journal::FileHeader::Magic)
+        throw std::runtime_error("ReplayCallbacks: " + path + " is not a callback journal");
+    if (h.version > journal::FileHeader::Version)
+        throw std::runtime_error("ReplayCallbacks: " + path + " has unsupported version " + std::to_string(h.version));
+    remaining -= sizeof(h);
+
+    ReplayStats st;
+    const auto t0 = std::chrono::steady_clock::now();
+    journal::Frame f;
+    std::vector<char> buf;
+    while (remaining > 0) {
+        if (remaining < sizeof(f) || !in.read(reinterpret_cast<char*>(&f), sizeof(f))) {
+            st.Torn = true; // Partial frame header
+            break;
+        }
+        remaining -= sizeof(f);
+        if (f.length > remaining) { // Torn or corrupt length, never allocate past the file
+            st.Torn = true;
+            break;
+        }
+        remaining -= f.length;
+        buf.resize(f.length);
+        if (!in.read(buf.data(), f.length) || journal::Check(buf.data(), buf.size()) != f.checksum) {
+            st.Torn = true;
+            break;
+        }
+
+        if (speed > 0) {
+            const auto due = t0 + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(f.offsetNs) / speed));
+            const auto now = std::chrono::steady_clock::now();
+            if (due > now) std::this_thread::sleep_until(due);
+            else st.MaxLagUs = std::max(st.MaxLagUs, std::chrono::duration<double, std::micro>(now - due).count());
+        }
+
+        BinReader r(std::move(buf));
+        switch (f.kind) {
+            case journal::Kind::TickPrice: {
+                int64_t id; int32_t field; double price; uint8_t bits;
+                r.val(id); r.val(field); r.val(price); r.val(bits);
+                TickAttrib attrib;
+                attrib.canAutoExecute = bits & 1;
+                attrib.pastLimit = bits >> 1 & 1;
+                attrib.preOpen = bits >> 2 & 1;
+                wrapper.tickPrice(id, static_cast<TickType>(field), price, attrib);
+                ++st.Ticks;
+                break;
+            }
+            case journal::Kind::HistoricalData: {
+                int64_t id;
+                Bar bar;
+                r.val(id);
+                bar.time = r.str();
+                r.val(bar.high); r.val(bar.low); r.val(bar.open); r.val(bar.close);
+                r.val(bar.wap); r.val(bar.volume); r.val(bar.count);
+                wrapper.historicalData(id, bar);
+                ++st.Bars;
+                break;
+            }
+            case journal::Kind::HistoricalDataEnd: {
+                int reqId;
+                r.val(reqId);
+                const std::string startDate = r.str();
+                const std::string endDate = r.str();
+                wrapper.historicalDataEnd(reqId, startDate, endDate);
+                ++st.Ends;
+                break;
+            }
+            case journal::Kind::Error: {
+                int id, code; int64_t when;
+                std::string msg, json;
+                r.val(id); r.val(when); r.val(code);
+                r.readValue(msg); r.readValue(json);
+                wrapper.error(id, static_cast<time_t>(when), code, msg, json);
+                ++st.Errors;
+                break;
+            }
+            default:
+                throw std::runtime_error("ReplayCallbacks: unknown record kind in " + path);
+        }
+        if (!r.ok()) throw std::runtime_error("ReplayCallbacks: malformed record in " + path);
+        ++st.Records;
+        st.RecordedSeconds = static_cast<double>(f.offsetNs) * 1e-9;
+        buf = {};
+    }
+    if (st.Torn) IBAT_WARN("ReplayCallbacks: stopped at a torn record after {} records", st.Records);
+    st.WallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return st;
+}
\ No newline at end of file
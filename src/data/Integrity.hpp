@@ -0,0 +1,160 @@
+#pragma once
+
+#include <BOT.hpp>
+#include <Jobs.hpp>
+
+//? Column view of one symbol's stored bars, as read from the database.
+struct BarColumns {
+    std::span<const int64_t> time;
+    std::span<const double> open;
+    std::span<const double> high;
+    std::span<const double> low;
+    std::span<const double> close;
+    std::span<const double> volume;
+};
+
+struct IntegrityConfig {
+    int64_t Step = 60;              // Expected seconds between bars
+    int64_t SessionBreak = 4 * 3600;// Larger gaps are session boundaries, not missing data
+    double JumpPct = 0.25;          // Close-to-close move counted as an outlier
+    bool CollectRepairs = false;
+};
+
+//? Range of missing bars to re-request.
+struct RepairRequest {
+    int Sym;
+    int64_t From;
+    int64_t To;
+};
+
+struct IntegrityReport {
+    int Sym = -1;
+    size_t Bars = 0;
+    size_t Gaps = 0;
+    size_t Duplicates = 0;
+    size_t NonMonotonic = 0;
+    size_t BadOHLC = 0;
+    size_t BadVolume = 0;
+    size_t Jumps = 0;
+    std::vector<RepairRequest> Repairs;
+
+    [[nodiscard]] bool Clean() const {
+        return Gaps + Duplicates + NonMonotonic + BadOHLC + BadVolume + Jumps == 0;
+    }
+};
+
+//? Checks one symbol. Every check is a branch-free counting loop over contiguous columns so the compiler
+//? vectorizes it; offending positions are only located in a second pass when repairs are requested.
+inline IntegrityReport ScanBars(const int sym, const BarColumns &b, const IntegrityConfig &cfg = {}) {
+    IntegrityReport r;
+    r.Sym = sym;
+    r.Bars = b.time.size();
+    const size_t n = r.Bars;
+    if (n == 0) return r;
+
+    const int64_t* t = b.time.data();
+    const double* o = b.open.data();
+    const double* h = b.high.data();
+    const double* l = b.low.data();
+    const double* c = b.close.data();
+    const double* v = b.volume.data();
+
+    size_t gaps = 0, dups = 0, back = 0;
+    for (size_t i = 1; i < n; ++i) {
+        const int64_t d = t[i] - t[i - 1];
+        dups += d == 0;
+        back += d < 0;
+        gaps += (d > cfg.Step) & (d < cfg.SessionBreak);
+    }
+
+    size_t ohlc = 0, vol = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double lo = l[i], hi = h[i];
+        ohlc += (lo > o[i]) | (lo > c[i]) | (hi < o[i]) | (hi < c[i]) | (lo > hi) | !(lo > 0);
+        vol += !(v[i] > 0);
+    }
+
+    size_t jumps = 0;
+    const double jump = cfg.JumpPct;
+    for (size_t i = 1; i < n; ++i)
+        jumps += std::abs(c[i] - c[i - 1]) > jump * c[i - 1];
+
+    r.Gaps = gaps;
+    r.Duplicates = dups;
+    r.NonMonotonic = back;
+    r.BadOHLC = ohlc;
+    r.BadVolume = vol;
+    r.Jumps = jumps;
+
+    if (cfg.CollectRepairs && gaps + dups + back > 0) {
+        for (size_t i = 1; i < n; ++i) {
+            const int64_t d = t[i] - t[i - 1];
+            if (d > cfg.Step && d < cfg.SessionBreak)
+                r.Repairs.push_back({sym, t[i - 1] + cfg.Step, t[i] - cfg.Step});
+            else if (d <= 0)
+                r.Repairs.push_back({sym, std::min(t[i], t[i - 1]), std::max(t[i], t[i - 1])});
+        }
+    }
+    return r;
+}
+
+//? Scans symbols [0, numSymbols) across worker threads. Symbols are handed out through an atomic counter,
+//? so long histories do not stall a statically assigned partition.
+/// @param load Loads a symbol's columns into the worker's storage and returns a view of them.
+template<typename Storage>
+std::vector<IntegrityReport> ScanUniverse(const int numSymbols,
+                                          const std::function<BarColumns(int, Storage&)> &load,
+                                          const IntegrityConfig &cfg = {},
+                                          unsigned threads = std::thread::hardware_concurrency(),
+                                          const CancelToken &cancel = job::Token()) {
+    std::vector<IntegrityReport> reports(numSymbols);
+    std::atomic<int> next{0};
+    std::vector<std::thread> workers;
+    std::mutex errTex;
+    std::exception_ptr failure;
+
+    for (unsigned w = 0; w < std::max(1u, threads); ++w) {
+        workers.emplace_back([&] {
+            Storage storage{};
+            try {
+                for (int s = next++; s < numSymbols; s = next++) {
+                    cancel.Check();
+                    reports[s] = ScanBars(s, load(s, storage), cfg);
+                }
+            } catch (...) {
+                std::lock_guard lock(errTex);
+                if (!failure) failure = std::current_exception();
+                next = numSymbols;
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    if (failure) std::rethrow_exception(failure);
+    return reports;
+}
+
+//? One line per symbol with findings, followed by universe totals.
+inline void PrintIntegrity(const std::vector<IntegrityReport> &reports) {
+    auto out = ibat::sout;
+    IntegrityReport total;
+    size_t dirty = 0;
+    for (const auto &r : reports) {
+        total.Bars += r.Bars;
+        total.Gaps += r.Gaps;
+        total.Duplicates += r.Duplicates;
+        total.NonMonotonic += r.NonMonotonic;
+        total.BadOHLC += r.BadOHLC;
+        total.BadVolume += r.BadVolume;
+        total.Jumps += r.Jumps;
+        total.Repairs.insert(total.Repairs.end(), r.Repairs.begin(), r.Repairs.end());
+        if (r.Clean()) continue;
+        ++dirty;
+        out << YELLOW << SYMBOLS[r.Sym] << RES << " bars " << r.Bars << " gaps " << r.Gaps
+            << " dup " << r.Duplicates << " order " << r.NonMonotonic << " ohlc " << r.BadOHLC
+            << " vol " << r.BadVolume << " jumps " << r.Jumps << std::endl;
+    }
+    out << GREEN << reports.size() - dirty << "/" << reports.size() << " symbols clean" << RES
+        << " | bars " << total.Bars << " gaps " << total.Gaps << " dup " << total.Duplicates
+        << " order " << total.NonMonotonic << " ohlc " << total.BadOHLC << " vol " << total.BadVolume
+        << " jumps " << total.Jumps << " repairs " << total.Repairs.size() << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <PackedBars.hpp>
+#include <Jobs.hpp>
+
+//? One symbol's bars in time order, delivered in blocks. Returns the number of bars written, 0 when exhausted.
+struct IBarSource {
+    virtual ~IBarSource() = default;
+    virtual size_t Next(std::vector<BarRow> &block) = 0;
+};
+
+//? Source backed by a callable, e.g. a paged database query.
+struct FnSource final : IBarSource {
+    explicit FnSource(std::function<size_t(std::vector<BarRow>&)> fn) : fn(std::move(fn)) {}
+    size_t Next(std::vector<BarRow> &block) override {return fn(block);}
+    std::function<size_t(std::vector<BarRow>&)> fn;
+};
+
+//? Source over an in-memory compressed history, one decoded block at a time.
+struct PackedSource final : IBarSource {
+    explicit PackedSource(const PackedBars &bars) : bars(bars) {}
+    size_t Next(std::vector<BarRow> &block) override {
+        if (i >= bars.Blocks()) return 0;
+        bars.Decode(i++, block);
+        return block.size();
+    }
+    const PackedBars &bars;
+    size_t i = 0;
+};
+
+//? Small fixed pool that runs the read-aheads of every PrefetchSource, so thousands of symbols prefetch on a
+//? handful of threads instead of one thread each. Tasks are run FIFO and must not wait on other tasks.
+class PrefetchPool {
+public:
+    explicit PrefetchPool(const unsigned threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 8u)) {
+        for (unsigned t = 0; t < std::max(1u, threads); ++t)
+            workers.emplace_back([this] {work();});
+    }
+
+    ~PrefetchPool() {
+        {
+            std::lock_guard lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto &w : workers) w.join();
+    }
+
+    PrefetchPool(const PrefetchPool&) = delete;
+    PrefetchPool &operator=(const PrefetchPool&) = delete;
+
+    static PrefetchPool &Default() {
+        static PrefetchPool pool;
+        return pool;
+    }
+
+    template<typename F>
+    std::future<std::invoke_result_t<F>> Post(F &&f) {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(f));
+        auto fut = task->get_future();
+        {
+            std::lock_guard lock(mtx);
+            tasks.emplace_back([task] {(*task)();});
+        }
+        cv.notify_one();
+        return fut;
+    }
+
+private:
+    //? Drains the queue before stopping so no posted read is left with a broken promise.
+    void work() {
+        std::unique_lock lock(mtx);
+        while (true) {
+            cv.wait(lock, [&] {return stopping || !tasks.empty();});
+            if (tasks.empty()) return;
+            auto fn = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            fn();
+            lock.lock();
+        }
+    }
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+};
+
+//? Reads the next block of the wrapped source on a PrefetchPool while the current one is consumed.
+//? Errors of the wrapped source are rethrown from the Next call that would have returned the block.
+struct PrefetchSource final : IBarSource {
+    explicit PrefetchSource(std::unique_ptr<IBarSource> src, PrefetchPool &pool = PrefetchPool::Default())
+        : src(std::move(src)), pool(pool) {request();}
+    ~PrefetchSource() override {if (next.valid()) next.wait();}
+
+    //& Returns 0 once exhausted, also on every call after that.
+    size_t Next(std::vector<BarRow> &block) override {
+        if (!next.valid()) return 0;
+        const size_t n = next.get();
+        std::swap(block, spare);
+        if (n > 0) request();
+        return n;
+    }
+
+private:
+    void request() {next = pool.Post([this] {return src->Next(spare);});}
+
+    std::unique_ptr<IBarSource> src;
+    PrefetchPool &pool;
+    std::vector<BarRow> spare;
+    std::future<size_t> next;
+};
+
+//? K-way merge of per-symbol sources into a single stream ordered by (time, symbol).
+//? Only the current block of each symbol is resident, so memory is bounded by symbols x block size.
+class MergedFeed {
+public:
+    explicit MergedFeed(std::vector<std::unique_ptr<IBarSource>> sources)
+        : sources(std::move(sources)), cursors(this->sources.size()) {
+        for (int s = 0; s < static_cast<int>(this->sources.size()); ++s)
+            if (refill(s)) heap.push({cursors[s].block[0].time, s});
+    }
+
+    //& Advances to the next bar in time order, false once every source is exhausted.
+    bool Next(int &sym, const BarRow* &bar) {
+        if (pendingAdvance >= 0) advance(pendingAdvance);
+        if (heap.empty()) return false;
+        sym = heap.top().sym;
+        heap.pop();
+        bar = &cursors[sym].block[cursors[sym].pos];
+        pendingAdvance = sym;
+        ++Delivered;
+        return true;
+    }
+
+    //& Calls f(sym, bar) for every bar in time order.
+    template<typename F>
+    void Run(F &&f) {
+        int sym;
+        const BarRow* bar;
+        while (Next(sym, bar)) {
+            if ((Delivered & CancelEvery) == 0) Cancel.Check();
+            f(sym, *bar);
+        }
+    }
+
+    //& Calls f(time, bars) once per timestamp with every symbol's bar at that time, for cross-sectional logic.
+    template<typename F>
+    void RunGrouped(F &&f) {
+        std::vector<std::pair<int, BarRow>> group;
+        int sym;
+        const BarRow* bar;
+        while (Next(sym, bar)) {
+            if ((Delivered & CancelEvery) == 0) Cancel.Check();
+            if (!group.empty() && bar->time != group.front().second.time) {
+                f(group.front().second.time, std::span<const std::pair<int, BarRow>>(group));
+                group.clear();
+            }
+            group.emplace_back(sym, *bar);
+        }
+        if (!group.empty()) f(group.front().second.time, std::span<const std::pair<int, BarRow>>(group));
+    }
+
+    uint64_t Delivered = 0;
+    //? Checked every CancelEvery + 1 bars by Run/RunGrouped, taken from the job constructing the feed.
+    CancelToken Cancel = job::Token();
+    static constexpr uint64_t CancelEvery = 4095;
+
+private:
+    struct Cursor {
+        std::vector<BarRow> block;
+        size_t pos = 0;
+    };
+
+    struct Head {
+        int64_t time;
+        int sym;
+        bool operator>(const Head &o) const {return time != o.time ? time > o.time : sym > o.sym;}
+    };
+
+    bool refill(const int s) {
+        Cursor &c = cursors[s];
+        c.pos = 0;
+        if (sources[s]->Next(c.block) == 0) {
+            c.block.clear();
+            c.block.shrink_to_fit();
+            return false;
+        }
+        return true;
+    }
+
+    void advance(const int s) {
+        pendingAdvance = -1;
+        Cursor &c = cursors[s];
+        if (++c.pos >= c.block.size() && !refill(s)) return;
+        heap.push({c.block[c.pos].time, s});
+    }
+
+    std::vector<std::unique_ptr<IBarSource>> sources;
+    std::vector<Cursor> cursors;
+    std::priority_queue<Head, std::vector<Head>, std::greater<>> heap;
+    int pendingAdvance = -1;
+};
\ No newline at end of file
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <EWrapper.h>
+#include <Decimal.h>
+
+struct MockTwsConfig {
+    int Symbols = 2000;
+    double TicksPerSecond = 5;       // Mean per symbol outside bursts
+    double BurstMultiplier = 20;     // Rate multiplier while a burst is on
+    double BurstSeconds = 0.5;       // Mean burst length
+    double CalmSeconds = 5;          // Mean time between bursts
+    int BarsPerRequest = 390;
+    int BarSeconds = 60;
+    double ErrorRate = 0;            // Chance a historical request fails with a data error
+    int PacingLimit = 60;            // Historical requests allowed per pacing window before error 162
+    double PacingWindowSeconds = 600;
+    double RunSeconds = 0;           // Tick stream stops after this long, 0 runs until Stop()
+    uint64_t Seed = 42;
+};
+
+//? Log2 microsecond histogram, lock free on the record path.
+struct LatencyHistogram {
+    static constexpr int Buckets = 32;
+    std::array<std::atomic<uint64_t>, Buckets> counts{};
+
+    void Record(const double us) {
+        const int b = us < 1 ? 0 : std::min(Buckets - 1, static_cast<int>(std::log2(us)) + 1);
+        counts[b].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //& Upper bound in microseconds of the bucket holding quantile q.
+    [[nodiscard]] double Quantile(const double q) const {
+        uint64_t total = 0;
+        for (const auto &c : counts) total += c.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+        const auto target = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+        uint64_t acc = 0;
+        for (int b = 0; b < Buckets; ++b) {
+            acc += counts[b].load(std::memory_order_relaxed);
+            if (acc >= target) return std::ldexp(1.0, b);
+        }
+        return std::ldexp(1.0, Buckets);
+    }
+
+    [[nodiscard]] uint64_t Count() const {
+        uint64_t total = 0;
+        for (const auto &c : counts) total += c.load(std::memory_order_relaxed);
+        return total;
+    }
+};
+
+//? Local stand-in for TWS. Serves the EClientSocket requests the executor makes (historical bars, market
+//? data, ids, time) and drives the EWrapper callbacks from one delivery thread, like EReader does, with
+//? synthetic bars and a bursty tick stream (calm/burst Markov modulated Poisson). Pacing violations
+//? (code 162) and data errors are injected per the config. Tick-to-signal latency is measured from the
+//? emission of each symbol's latest tick to Signal(sym).
+class MockTws {
+public:
+    explicit MockTws(EWrapper &wrapper, MockTwsConfig cfg = {})
+        : wrapper(wrapper), cfg(std::move(cfg)), lastEmit(std::max(1, this->cfg.Symbols)) {}
+
+    ~MockTws() {Stop();}
+
+    MockTws(const MockTws&) = delete;
+    MockTws &operator=(const MockTws&) = delete;
+
+    //& EClientSocket surface used by the executor
+    void reqCurrentTime() {
+        post([this] {wrapper.currentTime(static_cast<long>(std::time(nullptr)));});
+    }
+
+    void reqIds(int) {
+        post([this] {wrapper.nextValidId(nextId++);});
+    }
+
+    void reqHistoricalData(const TickerId reqId, const Contract&, const std::string &endDateTime,
+                           const std::string&, const std::string&, const std::string&, int, int, bool,
+                           const TagValueListSPtr&) {
+        post([this, reqId, endDateTime] {serveHistorical(reqId, endDateTime);});
+    }
+
+    void reqMktData(const TickerId id, const Contract&, const std::string&, bool, bool, const TagValueListSPtr&) {
+        std::lock_guard lock(mtx);
+        if (id >= 0 && id < cfg.Symbols) subscribed.insert(static_cast<int>(id));
+        ++generation;
+    }
+
+    void cancelMktData(const TickerId id) {
+        std::lock_guard lock(mtx);
+        subscribed.erase(static_cast<int>(id));
+        ++generation;
+    }
+
+    //& Subscribes every configured symbol, for load tests that skip the contract setup.
+    void SubscribeAll() {
+        std::lock_guard lock(mtx);
+        for (int s = 0; s < cfg.Symbols; ++s) subscribed.insert(s);
+        ++generation;
+    }
+
+    void Start() {
+        if (running.exchange(true)) return;
+        started = std::chrono::steady_clock::now();
+        worker = std::thread([this] {run();});
+    }
+
+    void Stop() {
+        if (!running.exchange(false)) return;
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    [[nodiscard]] bool Running() const {return running.load();}
+
+    //& Called by the consumer when the latest tick of sym has produced a signal (or finished processing).
+    void Signal(const int sym) {
+        if (sym < 0 || sym >= static_cast<int>(lastEmit.size())) return;
+        const int64_t t = lastEmit[sym].load(std::memory_order_acquire);
+        if (t == 0) return;
+        latency.Record(static_cast<double>(nowNs() - t) * 1e-3);
+    }
+
+    //& Sampled every 10ms on the delivery thread, e.g. the executor's data queue size.
+    std::function<size_t()> QueueDepth = nullptr;
+
+    struct Metrics {
+        uint64_t Ticks, Bars, Requests, Errors, PacingViolations;
+        double Seconds, MaxQueue, MeanQueue, P50Us, P99Us, P999Us;
+        uint64_t Signals;
+    };
+
+    [[nodiscard]] Metrics Stats() const {
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        const uint64_t samples = queueSamples.load();
+        return {ticks.load(), bars.load(), requests.load(), errors.load(), pacing.load(), secs,
+                static_cast<double>(maxQueue.load()),
+                samples ? static_cast<double>(queueSum.load()) / static_cast<double>(samples) : 0.0,
+                latency.Quantile(0.5), latency.Quantile(0.99), latency.Quantile(0.999), latency.Count()};
+    }
+
+    void Print() const {
+        const Metrics m = Stats();
+        auto out = ibat::sout;
+        out << PURPLE << "MockTws " << RES << m.Seconds << "s: " << m.Ticks << " ticks ("
+            << static_cast<double>(m.Ticks) / std::max(m.Seconds, 1e-9) << "/s), " << m.Bars << " bars over "
+            << m.Requests << " requests, " << m.Errors << " errors, " << m.PacingViolations << " pacing" << std::endl;
+        out << "  queue max " << m.MaxQueue << " mean " << m.MeanQueue << ", tick-to-signal p50 <" << m.P50Us
+            << "us p99 <" << m.P99Us << "us p99.9 <" << m.P999Us << "us over " << m.Signals << " signals" << std::endl;
+    }
+
+private:
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void post(std::function<void()> fn) {
+        {
+            std::lock_guard lock(mtx);
+            pendingRequests.push_back(std::move(fn));
+        }
+        cv.notify_one();
+    }
+
+    void serveHistorical(const TickerId reqId, const std::string &endDateTime) {
+        requests.fetch_add(1, std::memory_order_relaxed);
+        const double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        while (!pacingWindow.empty() && now - pacingWindow.front() > cfg.PacingWindowSeconds) pacingWindow.pop_front();
+        if (static_cast<int>(pacingWindow.size()) >= cfg.PacingLimit) {
+            pacing.fetch_add(1, std::memory_order_relaxed);
+            errors.fetch_add(1, std::memory_order_relaxed);
+            wrapper.error(static_cast<int>(reqId), std::time(nullptr), 162,
+                          "Historical Market Data Service error message:Historical data request pacing violation", "");
+            return;
+        }
+        pacingWindow.push_back(now);
+
+        if (std::uniform_real_distribution<double>(0, 1)(rng) < cfg.ErrorRate) {
+            errors.fetch_add(1, std::memory_order_relaxed);
+            wrapper.error(static_cast<int>(reqId), std::time(nullptr), 162,
+                          "Historical Market Data Service error message:HMDS query returned no data", "");
+            return;
+        }
+
+        // Bars end at the requested end time (yyyymmdd hh:mm:ss), or now when it is empty
+        std::time_t end = std::time(nullptr);
+        if (endDateTime.size() >= 17) {
+            std::tm tm{};
+            std::istringstream(endDateTime.substr(0, 17)) >> std::get_time(&tm, "%Y%m%d %H:%M:%S");
+            end = std::mktime(&tm);
+        }
+        std::normal_distribution<double> ret(0, 0.001);
+        double px = 20 + static_cast<double>(reqId % 500);
+        char buf[32];
+        for (int i = cfg.BarsPerRequest; i > 0; --i) {
+            const std::time_t t = end - static_cast<std::time_t>(i) * cfg.BarSeconds;
+            std::strftime(buf, sizeof(buf), "%Y%m%d %H:%M:%S", std::localtime(&t));
+            const double open = px;
+            px *= std::exp(ret(rng));
+            const double spread = std::abs(ret(rng)) * px;
+            Bar b;
+            b.time = buf;
+            b.open = open;
+            b.close = px;
+            b.high = std::max(open, px) + spread;
+            b.low = std::min(open, px) - spread;
+            b.volume = DecimalFunctions::doubleToDecimal(std::floor(1000 + 500 * std::abs(ret(rng)) * 1000));
+            b.wap = DecimalFunctions::doubleToDecimal((open + px) / 2);
+            b.count = 10 + static_cast<int>(reqId % 90);
+            wrapper.historicalData(reqId, b);
+            bars.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::strftime(buf, sizeof(buf), "%Y%m%d %H:%M:%S", std::localtime(&end));
+        wrapper.historicalDataEnd(static_cast<int>(reqId), "", buf);
+    }
+
+    //? Delivery loop: requests first, then every tick due by now, then sleep until the next tick or request.
+    void run() {
+        std::vector<double> prices(cfg.Symbols);
+        for (int s = 0; s < cfg.Symbols; ++s) prices[s] = 20 + s % 500;
+        std::exponential_distribution<double> calm(1.0 / cfg.CalmSeconds), burst(1.0 / cfg.BurstSeconds);
+        std::normal_distribution<double> ret(0, 0.0002);
+
+        const auto t0 = std::chrono::steady_clock::now();
+        double clock = 0, regimeEnd = calm(rng), lastSample = 0;
+        bool bursting = false;
+        std::vector<int> symbols;
+        uint64_t seen = 0; // generation symbols was built at
+
+        while (running.load(std::memory_order_relaxed)) {
+            std::deque<std::function<void()>> work;
+            {
+                std::lock_guard lock(mtx);
+                work.swap(pendingRequests);
+                if (seen != generation) {
+                    symbols.assign(subscribed.begin(), subscribed.end());
+                    seen = generation;
+                }
+            }
+            for (auto &fn : work) fn();
+
+            const double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            if (cfg.RunSeconds > 0 && now >= cfg.RunSeconds && !symbols.empty()) {
+                symbols.clear();
+                std::lock_guard lock(mtx);
+                subscribed.clear();
+                seen = ++generation;
+            }
+            if (now - lastSample >= 0.01) {
+                lastSample = now;
+                if (QueueDepth) {
+                    const size_t q = QueueDepth();
+                    queueSum.fetch_add(q, std::memory_order_relaxed);
+                    queueSamples.fetch_add(1, std::memory_order_relaxed);
+                    if (q > maxQueue.load(std::memory_order_relaxed)) maxQueue.store(q, std::memory_order_relaxed);
+                }
+            }
+
+            if (symbols.empty()) {
+                clock = now;
+                std::unique_lock lock(mtx);
+                cv.wait_for(lock, std::chrono::milliseconds(10),
+                            [this] {return !pendingRequests.empty() || !subscribed.empty() || !running.load();});
+                continue;
+            }
+
+            std::uniform_int_distribution<size_t> pick(0, symbols.size() - 1);
+            const double rate = static_cast<double>(symbols.size()) * cfg.TicksPerSecond;
+            while (clock <= now) {
+                if (clock >= regimeEnd) {
+                    bursting = !bursting;
+                    regimeEnd = clock + (bursting ? burst(rng) : calm(rng));
+                }
+                const int s = symbols[pick(rng)];
+                prices[s] *= std::exp(ret(rng));
+                lastEmit[s].store(nowNs(), std::memory_order_release);
+                wrapper.tickPrice(s, LAST, prices[s], TickAttrib{});
+                ticks.fetch_add(1, std::memory_order_relaxed);
+                clock += std::exponential_distribution<double>(rate * (bursting ? cfg.BurstMultiplier : 1.0))(rng);
+            }
+
+            std::unique_lock lock(mtx);
+            cv.wait_until(lock, t0 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(clock)),
+                          [this] {return !pendingRequests.empty() || !running.load();});
+        }
+    }
+
+    EWrapper &wrapper;
+    MockTwsConfig cfg;
+    std::mt19937_64 rng{cfg.Seed};
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> pendingRequests;
+    std::set<int> subscribed;
+    uint64_t generation = 0; // Bumped on every subscription change, guarded by mtx
+    std::deque<double> pacingWindow;
+    OrderId nextId = 1;
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+    std::vector<std::atomic<int64_t>> lastEmit;
+    LatencyHistogram latency;
+    std::atomic<uint64_t> ticks{0}, bars{0}, requests{0}, errors{0}, pacing{0};
+    std::atomic<uint64_t> queueSum{0}, queueSamples{0}, maxQueue{0};
+};
\ No newline at end of file
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <BOT.hpp>
+
+//? Plain bar row produced by decoding, times in seconds. This is the subset of Bar the backtest reads,
+//? wap and count are not stored and the string time is replaced by epoch seconds, so it is not a Bar.
+struct BarRow {
+    int64_t time;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+static_assert(offsetof(BarRow, close) == offsetof(BarRow, open) + 3 * sizeof(double), "PackedBars copies open..close as one run");
+
+//? Append-only compressed bar history in fixed-size blocks.
+//? Per block: timestamps as zigzag varint delta-of-deltas, prices as integer ticks (the coarsest of
+//? 1e-2 / 1e-4 / 1e-6 that represents the block exactly) encoded relative to the previous close and
+//? bit-packed at the block's widest width, volumes as varints in hundredths. Regular minute bars cost
+//? ~1 byte of time, a few bytes of prices and 2-3 bytes of volume.
+//? Round trips are bit exact: a block whose prices do not decode back to the same doubles at any tick
+//? stores them raw, likewise volumes that are negative, NaN or finer than VolumeScale.
+class PackedBars {
+public:
+    static constexpr size_t BlockSize = 512;
+
+    void Append(const BarRow &b) {
+        pending.push_back(b);
+        if (pending.size() == BlockSize) seal();
+    }
+
+    [[nodiscard]] size_t size() const {return sealedBars + pending.size();}
+    [[nodiscard]] size_t Blocks() const {return blocks.size() + !pending.empty();}
+    //& Sealed blocks that fell back to raw prices or raw volumes.
+    [[nodiscard]] size_t RawBlocks() const {
+        return std::ranges::count_if(blocks, [](const Block &b) {return b.rawPrices || b.rawVolumes;});
+    }
+
+    [[nodiscard]] size_t Bytes() const {
+        size_t n = pending.capacity() * sizeof(BarRow);
+        for (const auto &b : blocks) n += sizeof(Block) + b.data.capacity();
+        return n;
+    }
+
+    //& Decodes block i into out, which is resized to the block's bar count.
+    void Decode(const size_t i, std::vector<BarRow> &out) const {
+        if (i == blocks.size()) {out.assign(pending.begin(), pending.end()); return;}
+        const Block &b = blocks[i];
+        out.resize(b.count);
+
+        const uint8_t* p = b.data.data();
+        int64_t t = b.t0;
+        int64_t dt = 0;
+        for (uint32_t k = 0; k < b.count; ++k) {
+            if (k > 0) {
+                dt += unzig(varint(p));
+                t += dt;
+            }
+            out[k].time = t;
+        }
+
+        if (b.rawPrices) {
+            for (uint32_t k = 0; k < b.count; ++k) {
+                std::memcpy(&out[k].open, p, 4 * sizeof(double));
+                p += 4 * sizeof(double);
+            }
+        } else {
+            BitReader bits(p, b.bitsBytes);
+            p += b.bitsBytes;
+            const double scale = Scales[b.tickExp];
+            int64_t prevClose = b.c0;
+            for (uint32_t k = 0; k < b.count; ++k) {
+                const int64_t o = prevClose + unzig(bits.get(b.widths[0]));
+                const int64_t c = o + unzig(bits.get(b.widths[1]));
+                const int64_t h = std::max(o, c) + unzig(bits.get(b.widths[2]));
+                const int64_t l = std::min(o, c) - unzig(bits.get(b.widths[3]));
+                out[k].open = static_cast<double>(o) / scale;
+                out[k].close = static_cast<double>(c) / scale;
+                out[k].high = static_cast<double>(h) / scale;
+                out[k].low = static_cast<double>(l) / scale;
+                prevClose = c;
+            }
+        }
+
+        for (uint32_t k = 0; k < b.count; ++k) {
+            if (b.rawVolumes) {
+                std::memcpy(&out[k].volume, p, sizeof(double));
+                p += sizeof(double);
+            } else {
+                out[k].volume = static_cast<double>(varint(p)) / VolumeScale;
+            }
+        }
+    }
+
+    //& Iterates the history block by block, reusing a single decode buffer.
+    template<typename F>
+    void ForEachBlock(F &&f) const {
+        std::vector<BarRow> buf;
+        buf.reserve(BlockSize);
+        for (size_t i = 0; i < Blocks(); ++i) {
+            Decode(i, buf);
+            f(std::span<const BarRow>(buf));
+        }
+    }
+
+    void clear() {
+        blocks.clear();
+        pending.clear();
+        sealedBars = 0;
+    }
+
+    //& Encodes the partial tail block and frees the staging buffer, call once appends are done to release the
+    //& raw rows. Appending afterwards is still valid and reallocates it.
+    void Seal() {
+        if (!pending.empty()) seal();
+        std::vector<BarRow>().swap(pending);
+    }
+
+    static constexpr double VolumeScale = 100.0; // Fractional share volumes to 2 decimals, finer ones go raw
+
+private:
+    //? Ticks as divisors, k / 100.0 rounds to the same double as parsing "k/100" so decimal prices round trip.
+    static constexpr double Scales[] = {1e2, 1e4, 1e6};
+    static constexpr double MaxTicks = 9007199254740992.0; // 2^53, beyond it tick counts lose integers
+
+    struct Block {
+        int64_t t0 = 0;
+        int64_t c0 = 0;              // Reference close in ticks
+        uint32_t count = 0;
+        uint32_t bitsBytes = 0;
+        uint8_t tickExp = 0;
+        bool rawPrices = false;      // 4 doubles per bar instead of the bit-packed ticks
+        bool rawVolumes = false;     // 1 double per bar instead of varints
+        std::array<uint8_t, 4> widths{};
+        std::vector<uint8_t> data;
+    };
+
+    struct BitWriter {
+        std::vector<uint8_t> &out;
+        uint64_t acc = 0;
+        int fill = 0;
+        void put(uint64_t v, const int w) {
+            if (w == 0) return;
+            for (int done = 0; done < w;) {
+                const int take = std::min(w - done, 64 - fill);
+                const uint64_t chunk = take == 64 ? v : v & ((1ull << take) - 1);
+                acc |= chunk << fill;
+                fill += take;
+                done += take;
+                v = take == 64 ? 0 : v >> take;
+                while (fill >= 8) {out.push_back(static_cast<uint8_t>(acc)); acc >>= 8; fill -= 8;}
+            }
+        }
+        void flush() {if (fill > 0) {out.push_back(static_cast<uint8_t>(acc)); acc = 0; fill = 0;}}
+    };
+
+    struct BitReader {
+        const uint8_t* p;
+        size_t n;
+        size_t pos = 0;
+        uint64_t acc = 0;
+        int fill = 0;
+        BitReader(const uint8_t* data, const size_t bytes) : p(data), n(bytes) {}
+        uint64_t get(const int w) {
+            if (w == 0) return 0;
+            uint64_t v = 0;
+            for (int got = 0; got < w;) {
+                if (fill == 0) {acc = pos < n ? p[pos] : 0; ++pos; fill = 8;}
+                const int take = std::min(w - got, fill);
+                v |= (acc & ((1ull << take) - 1)) << got;
+                acc >>= take;
+                fill -= take;
+                got += take;
+            }
+            return v;
+        }
+    };
+
+    static uint64_t zig(const int64_t v) {return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);}
+    static int64_t unzig(const uint64_t v) {return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);}
+    static int width(const uint64_t v) {return v == 0 ? 0 : 64 - std::countl_zero(v);}
+
+    static void putVarint(std::vector<uint8_t> &out, uint64_t v) {
+        while (v >= 0x80) {out.push_back(static_cast<uint8_t>(v | 0x80)); v >>= 7;}
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    static uint64_t varint(const uint8_t* &p) {
+        uint64_t v = 0;
+        for (int shift = 0;; shift += 7) {
+            const uint8_t b = *p++;
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+    }
+
+    //? Bit exact round trip through an integer count of 1/scale, NaN and infinities fail.
+    static bool exact(const double v, const double scale) {
+        const double q = std::round(v * scale);
+        return std::abs(q) < MaxTicks && q / scale == v;
+    }
+
+    static void putRaw(std::vector<uint8_t> &out, const double* v, const size_t n) {
+        const auto* b = reinterpret_cast<const uint8_t*>(v);
+        out.insert(out.end(), b, b + n * sizeof(double));
+    }
+
+    void seal() {
+        Block b;
+        b.count = static_cast<uint32_t>(pending.size());
+        b.t0 = pending.front().time;
+
+        b.rawPrices = true;
+        for (uint8_t e = 0; e < std::size(Scales) && b.rawPrices; ++e) {
+            b.tickExp = e;
+            b.rawPrices = !std::ranges::all_of(pending, [&](const BarRow &r) {
+                return exact(r.open, Scales[e]) && exact(r.high, Scales[e]) && exact(r.low, Scales[e]) && exact(r.close, Scales[e]);
+            });
+        }
+        b.rawVolumes = !std::ranges::all_of(pending, [](const BarRow &r) {
+            return !std::signbit(r.volume) && exact(r.volume, VolumeScale);
+        });
+        const double scale = Scales[b.tickExp];
+        const auto ticks = [scale](const double p) {return static_cast<int64_t>(std::llround(p * scale));};
+
+        int64_t dt = 0;
+        for (size_t k = 1; k < pending.size(); ++k) {
+            const int64_t d = pending[k].time - pending[k - 1].time;
+            putVarint(b.data, zig(d - dt));
+            dt = d;
+        }
+
+        if (b.rawPrices) {
+            for (const auto &r : pending) putRaw(b.data, &r.open, 4);
+        } else {
+            packPrices(b, ticks);
+        }
+
+        for (const auto &r : pending) {
+            if (b.rawVolumes) putRaw(b.data, &r.volume, 1);
+            else putVarint(b.data, static_cast<uint64_t>(std::llround(r.volume * VolumeScale)));
+        }
+
+        b.data.shrink_to_fit();
+        sealedBars += b.count;
+        blocks.push_back(std::move(b));
+        pending.clear();
+    }
+
+    //? Four streams per bar: open vs previous close, close vs open, high above and low below the body.
+    //? Zigzag keeps inconsistent bars (high inside the body) lossless.
+    template<typename T>
+    void packPrices(Block &b, const T &ticks) const {
+        std::vector<std::array<uint64_t, 4>> fields(pending.size());
+        b.c0 = ticks(pending.front().open);
+        int64_t prevClose = b.c0;
+        for (size_t k = 0; k < pending.size(); ++k) {
+            const int64_t o = ticks(pending[k].open);
+            const int64_t c = ticks(pending[k].close);
+            const int64_t h = ticks(pending[k].high);
+            const int64_t l = ticks(pending[k].low);
+            fields[k] = {zig(o - prevClose), zig(c - o), zig(h - std::max(o, c)), zig(std::min(o, c) - l)};
+            for (int f = 0; f < 4; ++f)
+                b.widths[f] = static_cast<uint8_t>(std::max<int>(b.widths[f], width(fields[k][f])));
+            prevClose = c;
+        }
+
+        const size_t bitsStart = b.data.size();
+        BitWriter bw{b.data};
+        for (const auto &f : fields)
+            for (int i = 0; i < 4; ++i) bw.put(f[i], b.widths[i]);
+        bw.flush();
+        b.bitsBytes = static_cast<uint32_t>(b.data.size() - bitsStart);
+    }
+
+    std::vector<Block> blocks;
+    std::vector<BarRow> pending;
+    size_t sealedBars = 0;
+};
\ No newline at end of file
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <Common.hpp>
+
+//? Compile-time floor for the IBAT_* log macros, calls below it compile to nothing.
+//? 0 Trace, 1 Debug, 2 Info, 3 Warn, 4 Error, 5 Off.
+#ifndef IBAT_LOG_LEVEL
+#define IBAT_LOG_LEVEL 2
+#endif
+
+namespace ibat::log {
+    enum class Level : uint8_t {
+        Trace,
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Off
+    };
+
+    inline const char* LevelName(const Level l) {
+        static constexpr const char* names[] = {"TRACE", "DEBUG", "INFO ", "WARN ", "ERROR", "OFF  "};
+        return names[static_cast<uint8_t>(l)];
+    }
+
+    //? Compact binary record. The format string and any string arguments must have static storage
+    //? duration (literals), only their pointers are queued. Formatting happens on the logger thread.
+    struct Record {
+        static constexpr size_t MaxArgs = 6;
+
+        enum class Kind : uint8_t {Int, UInt, Real, Str};
+        union Arg {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const char* s;
+        };
+
+        int64_t ns;
+        const char* fmt;
+        Arg args[MaxArgs];
+        Kind kinds[MaxArgs];
+        Level level;
+        uint8_t nargs;
+        uint32_t thread;
+    };
+
+    //? Single producer, single consumer ring owned by one logging thread. When that thread exits the
+    //? ring is released and handed, once drained, to the next thread that logs, together with its id.
+    struct ThreadQueue {
+        static constexpr size_t Capacity = 1 << 12;
+
+        bool push(const Record &r) {
+            const uint64_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) == Capacity) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            ring[h & (Capacity - 1)] = r;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename F>
+        size_t drain(F &&f) {
+            const uint64_t t = tail.load(std::memory_order_relaxed);
+            const uint64_t h = head.load(std::memory_order_acquire);
+            for (uint64_t i = t; i < h; ++i) f(ring[i & (Capacity - 1)]);
+            tail.store(h, std::memory_order_release);
+            return h - t;
+        }
+
+        std::array<Record, Capacity> ring;
+        alignas(64) std::atomic<uint64_t> head{0};
+        alignas(64) std::atomic<uint64_t> tail{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> owned{true};
+        uint32_t id = 0;
+    };
+
+    template<typename T>
+    void pack(Record &r, const T &v) {
+        Record::Arg &a = r.args[r.nargs];
+        Record::Kind &k = r.kinds[r.nargs];
+        if constexpr (std::is_floating_point_v<T>) {a.d = v; k = Record::Kind::Real;}
+        else if constexpr (std::is_same_v<T, bool>) {a.u = v; k = Record::Kind::UInt;}
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {a.i = v; k = Record::Kind::Int;}
+        else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {a.u = static_cast<uint64_t>(v); k = Record::Kind::UInt;}
+        else if constexpr (std::is_convertible_v<T, const char*>) {a.s = v; k = Record::Kind::Str;}
+        else static_assert(!sizeof(T), "ibat::log: only numbers and static strings can be logged");
+        ++r.nargs;
+    }
+
+    //? Background logger. Threads push records into their own lock-free queue, one thread formats
+    //? them and writes to rotating files and optionally the terminal. The writer thread starts with the
+    //? first logging thread, so Configure can run before any file is opened.
+    //! Records are sorted by timestamp within each drained batch only. A record stamped just before a
+    //! drain but pushed just after it lands in the next batch, so lines from different threads can be
+    //! out of order by up to one drain interval (~2ms). Lines from a single thread are always in order.
+    class Logger {
+    public:
+        static Logger &Get() {
+            static Logger instance;
+            return instance;
+        }
+
+        struct Config {
+            std::filesystem::path Dir = "log";
+            std::string Prefix = "ibat";
+            size_t MaxFileBytes = 64ull << 20;
+            int MaxFiles = 8;
+        };
+
+        //& Replaces the file settings. Safe from any thread, the writer reopens its file with them before its
+        //& next batch, so a call after logging has started moves the rest of the log.
+        void Configure(Config c) {
+            if (c.MaxFiles < 1) throw std::runtime_error("Logger: MaxFiles must be at least 1");
+            std::lock_guard lock(cfgTex);
+            pendingCfg = std::move(c);
+            reconfigured.store(true, std::memory_order_release);
+        }
+        [[nodiscard]] Config Configuration() {
+            std::lock_guard lock(cfgTex);
+            return pendingCfg;
+        }
+
+        std::atomic<Level> TerminalLevel{Level::Warn};
+        std::atomic<Level> RuntimeLevel{static_cast<Level>(IBAT_LOG_LEVEL)};
+
+        template<typename... Args>
+        void Log(const Level level, const char* fmt, const Args&... args) {
+            static_assert(sizeof...(Args) <= Record::MaxArgs, "ibat::log: too many arguments");
+            if (level < RuntimeLevel.load(std::memory_order_relaxed)) return;
+
+            ThreadQueue &q = local();
+            Record r;
+            r.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            r.fmt = fmt;
+            r.level = level;
+            r.nargs = 0;
+            r.thread = q.id;
+            (pack(r, args), ...);
+            q.push(r);
+        }
+
+        [[nodiscard]] uint64_t Dropped() {
+            std::lock_guard lock(queuesTex);
+            uint64_t n = 0;
+            for (const auto &q : queues) n += q->dropped.load(std::memory_order_relaxed);
+            return n;
+        }
+
+        [[nodiscard]] uint64_t Written() const {return written.load(std::memory_order_relaxed);}
+
+        //& Blocks until everything queued before the call has been written.
+        void Flush() {
+            const uint64_t target = pushedSnapshot();
+            while (consumed.load(std::memory_order_acquire) < target)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        ~Logger() {
+            stopping = true;
+            if (worker.joinable()) worker.join();
+        }
+
+    private:
+        Logger() = default;
+
+        //? Releases the thread's queue on thread exit, the logger keeps it for reuse.
+        struct Lease {
+            std::shared_ptr<ThreadQueue> q;
+            ~Lease() {if (q) q->owned.store(false, std::memory_order_release);}
+        };
+
+        ThreadQueue &local() {
+            thread_local Lease lease;
+            if (!lease.q) lease.q = claim();
+            return *lease.q;
+        }
+
+        //? Reuses a released and fully drained queue before allocating a new one, so the number of
+        //? rings (and ids) is bounded by the peak number of concurrently logging threads. head keeps
+        //? counting across owners, which keeps pushedSnapshot monotonic for Flush.
+        std::shared_ptr<ThreadQueue> claim() {
+            std::call_once(started, [this] {worker = std::thread([this] {run();});});
+            std::lock_guard lock(queuesTex);
+            for (const auto &q : queues) {
+                if (q->owned.load(std::memory_order_acquire)) continue;
+                if (q->head.load(std::memory_order_relaxed) != q->tail.load(std::memory_order_acquire)) continue;
+                q->owned.store(true, std::memory_order_relaxed);
+                return q;
+            }
+            auto n = std::make_shared<ThreadQueue>();
+            n->id = static_cast<uint32_t>(queues.size());
+            queues.push_back(n);
+            return n;
+        }
+
+        uint64_t pushedSnapshot() {
+            std::lock_guard lock(queuesTex);
+            uint64_t n = 0;
+            for (const auto &q : queues) n += q->head.load(std::memory_order_acquire);
+            return n;
+        }
+
+        void run() {
+            std::vector<Record> batch;
+            std::string line;
+            while (true) {
+                if (reconfigured.exchange(false, std::memory_order_acquire)) {
+                    std::lock_guard lock(cfgTex);
+                    cfg = pendingCfg;
+                    file.close();
+                    fileBytes = 0;
+                }
+                batch.clear();
+                size_t n = 0;
+                {
+                    std::vector<std::shared_ptr<ThreadQueue>> qs;
+                    {
+                        std::lock_guard lock(queuesTex);
+                        qs = queues;
+                    }
+                    for (const auto &q : qs)
+                        n += q->drain([&](const Record &r) {batch.push_back(r);});
+                }
+
+                std::ranges::sort(batch, {}, &Record::ns);
+                for (const Record &r : batch) {
+                    format(r, line);
+                    write(r.level, line);
+                }
+                if (file.is_open()) file.flush();
+                consumed.fetch_add(n, std::memory_order_release);
+                written.fetch_add(batch.size(), std::memory_order_relaxed);
+
+                if (n == 0) {
+                    if (stopping) return;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+        }
+
+        static void format(const Record &r, std::string &out) {
+            const auto secs = static_cast<time_t>(r.ns / 1000000000);
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &secs);
+#else
+            localtime_r(&secs, &tm);
+#endif
+            char stamp[48];
+            const size_t len = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+            std::snprintf(stamp + len, sizeof(stamp) - len, ".%06lld", static_cast<long long>(r.ns / 1000 % 1000000));
+
+            out.clear();
+            out += stamp;
+            out += " ";
+            out += LevelName(r.level);
+            out += " [" + std::to_string(r.thread) + "] ";
+
+            size_t arg = 0;
+            for (const char* p = r.fmt; *p; ++p) {
+                if (p[0] == '{' && p[1] == '}' && arg < r.nargs) {
+                    const Record::Arg &a = r.args[arg];
+                    switch (r.kinds[arg++]) {
+                        case Record::Kind::Int:  out += std::to_string(a.i); break;
+                        case Record::Kind::UInt: out += std::to_string(a.u); break;
+                        case Record::Kind::Real: {
+                            char buf[32];
+                            std::snprintf(buf, sizeof(buf), "%.6g", a.d);
+                            out += buf;
+                            break;
+                        }
+                        case Record::Kind::Str:  out += a.s ? a.s : "(null)"; break;
+                    }
+                    ++p;
+                } else {
+                    out += *p;
+                }
+            }
+        }
+
+        void write(const Level level, const std::string &line) {
+            if (!file.is_open() || fileBytes > cfg.MaxFileBytes) rotate();
+            file << line << '\n';
+            fileBytes += line.size() + 1;
+            if (level >= TerminalLevel.load(std::memory_order_relaxed))
+                std::cout << line << '\n';
+        }
+
+        //? <Prefix>.log is always the newest file, older ones shift to <Prefix>.1.log ... <Prefix>.<MaxFiles-1>.log.
+        void rotate() {
+            file.close();
+            std::error_code ec;
+            std::filesystem::create_directories(cfg.Dir, ec);
+            const auto name = [&](const int i) {
+                return cfg.Dir / (i == 0 ? cfg.Prefix + ".log" : cfg.Prefix + "." + std::to_string(i) + ".log");
+            };
+            if (fileBytes > 0 || std::filesystem::exists(name(0), ec)) {
+                std::filesystem::remove(name(cfg.MaxFiles - 1), ec);
+                for (int i = cfg.MaxFiles - 2; i >= 0; --i)
+                    std::filesystem::rename(name(i), name(i + 1), ec);
+            }
+            file.open(name(0), std::ios::out | std::ios::trunc);
+            fileBytes = 0;
+        }
+
+        std::mutex cfgTex;
+        Config pendingCfg;                   // Guarded by cfgTex, picked up by the writer
+        Config cfg;                          // Writer thread only
+        std::atomic<bool> reconfigured{false};
+        std::once_flag started;
+        std::mutex queuesTex;
+        std::vector<std::shared_ptr<ThreadQueue>> queues;
+        std::ofstream file;
+        size_t fileBytes = 0;
+        std::atomic<uint64_t> consumed{0};
+        std::atomic<uint64_t> written{0};
+        std::atomic<bool> stopping{false};
+        std::thread worker;
+    };
+}
+
+#define IBAT_LOG(level, ...) \
+    do { \
+        if constexpr (static_cast<int>(level) >= IBAT_LOG_LEVEL) \
+            ibat::log::Logger::Get().Log(level, __VA_ARGS__); \
+    } while (0)
+
+#define IBAT_TRACE(...) IBAT_LOG(ibat::log::Level::Trace, __VA_ARGS__)
+#define IBAT_DEBUG(...) IBAT_LOG(ibat::log::Level::Debug, __VA_ARGS__)
+#define IBAT_INFO(...)  IBAT_LOG(ibat::log::Level::Info, __VA_ARGS__)
+#define IBAT_WARN(...)  IBAT_LOG(ibat::log::Level::Warn, __VA_ARGS__)
+#define IBAT_ERROR(...) IBAT_LOG(ibat::log::Level::Error, __VA_ARGS__)
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <barrier>
+
+#include <BOT.hpp>
+
+//? Data parallel CPU training over N model replicas on persistent worker threads.
+//? Each batch is split into contiguous shards, one per replica. Gradients are all-reduced
+//? in shared memory into the master module, which takes the optimizer step and is then
+//? broadcast back to the replicas.
+//!  Set at::set_num_threads(1) when running more than one replica, intra-op threads otherwise oversubscribe the cores.
+template<typename Holder>
+class DataParallel {
+public:
+    using Impl = typename Holder::Impl;
+    //? Computes the mean loss of samples [begin, end) of the current batch on the given replica.
+    using LossFn = std::function<torch::Tensor(Holder &replica, int64_t begin, int64_t end)>;
+
+    /// @param master Module holding the trained weights, must be torch::nn::Cloneable.
+    /// @param replicas Number of replicas and worker threads.
+    /// @param deterministic Reduce gradients in fixed replica order, otherwise accumulate in arrival order.
+    DataParallel(Holder master, const int replicas, const bool deterministic = true)
+        : Master(std::move(master)), Deterministic(deterministic),
+          N(std::max(1, replicas)), start(N + 1), finish(N + 1) {
+        for (int i = 0; i < N; ++i)
+            Replicas.emplace_back(std::dynamic_pointer_cast<Impl>(Master->clone()));
+        masterParams = Master->parameters();
+        for (auto &r : Replicas)
+            replicaParams.push_back(r->parameters());
+        losses.resize(N);
+
+        for (int i = 0; i < N; ++i) {
+            workers.emplace_back([this, i] {
+                while (true) {
+                    start.arrive_and_wait();
+                    if (stopping) return;
+                    try {
+                        job(i);
+                    } catch (...) {
+                        std::lock_guard lock(reduceTex);
+                        if (!failure) failure = std::current_exception();
+                    }
+                    finish.arrive_and_wait();
+                }
+            });
+        }
+    }
+
+    ~DataParallel() {
+        stopping = true;
+        start.arrive_and_wait();
+        for (auto &w : workers) w.join();
+    }
+
+    DataParallel(const DataParallel&) = delete;
+    DataParallel &operator=(const DataParallel&) = delete;
+
+    Holder Master;
+    std::vector<Holder> Replicas;
+    const bool Deterministic;
+
+    //& Runs one training step over a batch of batchSize samples and returns the batch mean loss.
+    double Step(torch::optim::Optimizer &opt, const int64_t batchSize, const LossFn &loss) {
+        opt.zero_grad();
+        for (auto &p : masterParams)
+            if (!p.grad().defined()) p.mutable_grad() = torch::zeros_like(p);
+
+        run([&](const int i) {
+            const auto [b, e] = Shard(batchSize, i);
+            losses[i] = 0;
+            for (auto &p : replicaParams[i])
+                if (p.grad().defined()) p.mutable_grad().zero_();
+            if (b == e) return;
+
+            //? Weight each shard's mean loss by its share so the summed gradients equal the full batch mean.
+            const double w = static_cast<double>(e - b) / static_cast<double>(batchSize);
+            torch::Tensor l = loss(Replicas[i], b, e) * w;
+            l.backward();
+            losses[i] = l.item<double>();
+
+            if (!Deterministic) {
+                std::lock_guard lock(reduceTex);
+                accumulate(i, 0, masterParams.size());
+            }
+        });
+
+        if (Deterministic) {
+            //? Parameters are partitioned across workers, each summing replicas in index order.
+            run([&](const int w) {
+                for (size_t p = w; p < masterParams.size(); p += N)
+                    for (int r = 0; r < N; ++r)
+                        accumulate(r, p, p + 1);
+            });
+        }
+
+        opt.step();
+
+        run([&](const int i) {
+            torch::NoGradGuard guard;
+            for (size_t p = 0; p < masterParams.size(); ++p)
+                replicaParams[i][p].copy_(masterParams[p]);
+            if (i != 0) {
+                auto src = Replicas[0]->buffers();
+                auto dst = Replicas[i]->buffers();
+                for (size_t b = 0; b < dst.size(); ++b) dst[b].copy_(src[b]);
+            }
+        });
+        syncBuffers();
+
+        double total = 0;
+        for (const double l : losses) total += l;
+        return total;
+    }
+
+    //& Contiguous shard [begin, end) of the batch for replica i.
+    [[nodiscard]] std::pair<int64_t, int64_t> Shard(const int64_t batchSize, const int i) const {
+        const int64_t base = batchSize / N;
+        const int64_t extra = batchSize % N;
+        const int64_t b = i * base + std::min<int64_t>(i, extra);
+        return {b, b + base + (i < extra ? 1 : 0)};
+    }
+
+    [[nodiscard]] int Size() const {return N;}
+
+private:
+    void run(const std::function<void(int)> &fn) {
+        job = fn;
+        start.arrive_and_wait();
+        finish.arrive_and_wait();
+        if (failure) {
+            auto f = failure;
+            failure = nullptr;
+            std::rethrow_exception(f);
+        }
+    }
+
+    void accumulate(const int r, const size_t begin, const size_t end) {
+        torch::NoGradGuard guard;
+        for (size_t p = begin; p < end; ++p) {
+            const auto &g = replicaParams[r][p].grad();
+            if (g.defined()) masterParams[p].mutable_grad().add_(g);
+        }
+    }
+
+    //? Running statistics (e.g. normalization buffers) follow replica 0.
+    void syncBuffers() {
+        torch::NoGradGuard guard;
+        auto src = Replicas[0]->buffers();
+        auto dst = Master->buffers();
+        for (size_t b = 0; b < dst.size(); ++b) dst[b].copy_(src[b]);
+    }
+
+    const int N;
+    std::vector<torch::Tensor> masterParams;
+    std::vector<std::vector<torch::Tensor>> replicaParams;
+    std::vector<double> losses;
+
+    std::function<void(int)> job;
+    std::barrier<> start;
+    std::barrier<> finish;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping = false;
+    std::mutex reduceTex;
+    std::exception_ptr failure = nullptr;
+};
+
+//? Measures training throughput of a model from 1 to maxThreads replicas (powers of two).
+/// @param make Builds a freshly initialized master model.
+/// @param loss Shard loss function, see DataParallel::LossFn.
+/// @param batchSize Samples per step.
+/// @param steps Timed steps per configuration, after one warm-up step.
+template<typename Holder>
+void DataParallelScaling(const std::function<Holder()> &make,
+                         const typename DataParallel<Holder>::LossFn &loss,
+                         const int64_t batchSize = 256, const int steps = 20, const int maxThreads = 32) {
+    const int prevThreads = at::get_num_threads();
+    at::set_num_threads(1);
+
+    auto out = ibat::sout;
+    out << "Threads  Samples/s   Speedup  Efficiency" << std::endl;
+    double base = 0;
+    for (int t = 1; t <= maxThreads; t *= 2) {
+        DataParallel<Holder> dp(make(), t);
+        torch::optim::SGD opt(dp.Master->parameters(), torch::optim::SGDOptions(1e-4));
+        dp.Step(opt, batchSize, loss);
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; ++s)
+            dp.Step(opt, batchSize, loss);
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        const double rate = static_cast<double>(batchSize * steps) / secs;
+        if (t == 1) base = rate;
+        out << std::setw(7) << t << std::setw(11) << std::fixed << std::setprecision(1) << rate
+            << std::setw(10) << std::setprecision(2) << rate / base
+            << std::setw(11) << std::setprecision(2) << rate / base / t << std::endl;
+    }
+
+    at::set_num_threads(prevThreads);
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <PerSymbol.hpp>
+
+struct LedgerLimits {
+    double MaxExposure = 1e12;      // Total open notional
+    double MaxLeverage = 1.0;       // Open notional as a multiple of balance
+    double MaxPositionValue = 1e12; // Notional of a single position
+    int MaxPositions = 1 << 20;
+};
+
+//? Consistent view of the book for risk checks. Exposure and open positions always come from the same instant.
+struct LedgerSnapshot {
+    double Balance;
+    double Exposure;
+    int Positions;
+    int64_t Trades;
+};
+
+//? Position bookkeeping without a portfolio lock.
+//? Open notional and position count are packed into one 64-bit word, so a risk-checked entry is a single
+//? CAS against the portfolio limits. Realized pnl is accumulated atomically in sym % shards to spread
+//? contention and merged on read. Per-symbol state is only touched by the thread owning the symbol.
+class ShardedLedger {
+public:
+    explicit ShardedLedger(const int shards = 1, const double balance = 0, const LedgerLimits limits = {})
+        : Limits(limits), startBalance(balance), shards(std::max(1, shards)) {}
+
+    LedgerLimits Limits;
+
+    [[nodiscard]] int ShardOf(const int sym) const {return sym % static_cast<int>(shards.size());}
+
+    //& Reserves notional for a new position on sym, false if any portfolio limit would be breached or sym
+    //& already holds one. Scaling into a position is a new entry only once the previous one has exited.
+    bool TryEnter(const int sym, const double notional) {
+        if (notional <= 0 || notional > Limits.MaxPositionValue || Holds(sym)) return false;
+        const uint64_t add = toCents(notional);
+        if (add == 0) return false; // Below a cent, would count a position Holds and Exit never see
+        const double buyingPower = Balance() * Limits.MaxLeverage;
+
+        uint64_t cur = book.load(std::memory_order_acquire);
+        while (true) {
+            const uint64_t exposure = (cur >> CountBits) + add;
+            const uint64_t count = (cur & CountMask) + 1;
+            const double exp = static_cast<double>(exposure) / 100.0;
+            if (exposure > ExposureMax || count > static_cast<uint64_t>(Limits.MaxPositions)
+                || exp > Limits.MaxExposure || exp > buyingPower)
+                return false;
+            if (book.compare_exchange_weak(cur, exposure << CountBits | count,
+                                           std::memory_order_acq_rel, std::memory_order_acquire))
+                break;
+        }
+        reserved[sym] = add;
+        return true;
+    }
+
+    //& Releases the position on sym and books its realized pnl to the symbol's shard.
+    void Exit(const int sym, const double pnl) {
+        const uint64_t cents = reserved[sym];
+        if (cents == 0) return;
+        reserved[sym] = 0;
+        book.fetch_sub(cents << CountBits | 1, std::memory_order_acq_rel);
+
+        Shard &s = shards[ShardOf(sym)];
+        s.realized.fetch_add(pnl, std::memory_order_acq_rel);
+        s.trades.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool Holds(const int sym) const {return reserved[sym] != 0;}
+
+    [[nodiscard]] double Balance() const {
+        double b = startBalance;
+        for (const auto &s : shards) b += s.realized.load(std::memory_order_acquire);
+        return b;
+    }
+
+    [[nodiscard]] LedgerSnapshot Snapshot() const {
+        const uint64_t b = book.load(std::memory_order_acquire);
+        int64_t trades = 0;
+        for (const auto &s : shards) trades += s.trades.load(std::memory_order_relaxed);
+        return {Balance(), static_cast<double>(b >> CountBits) / 100.0, static_cast<int>(b & CountMask), trades};
+    }
+
+    //& Sizes per-symbol state for a grown universe, existing symbols are not moved.
+    void Grow(const size_t slots) {reserved.Grow(slots);}
+
+    //& Independent copy of the balance, open book and reservations for a what-if run such as a walk-forward
+    //& fork. Not thread safe, call while nothing enters or exits.
+    [[nodiscard]] std::unique_ptr<ShardedLedger> Fork() const {
+        auto f = std::make_unique<ShardedLedger>(static_cast<int>(shards.size()), startBalance, Limits);
+        f->book.store(book.load(std::memory_order_acquire));
+        for (size_t i = 0; i < shards.size(); ++i) {
+            f->shards[i].realized.store(shards[i].realized.load(std::memory_order_acquire));
+            f->shards[i].trades.store(shards[i].trades.load(std::memory_order_relaxed));
+        }
+        f->reserved.Grow(reserved.size());
+        for (size_t s = 0; s < reserved.size(); ++s) f->reserved[s] = reserved[s];
+        return f;
+    }
+
+    //& Not thread safe, call between runs. The shard count is fixed at construction.
+    void Reset(const double balance) {
+        startBalance = balance;
+        book.store(0);
+        for (auto &s : shards) {s.realized.store(0); s.trades.store(0);}
+        reserved.Grow(Universe().Slots());
+        reserved.ResetAll();
+    }
+
+private:
+    static constexpr int CountBits = 24;
+    static constexpr uint64_t CountMask = (1ull << CountBits) - 1;
+    static constexpr uint64_t ExposureMax = (1ull << (64 - CountBits)) - 1; // ~$11B in cents
+
+    static uint64_t toCents(const double v) {return static_cast<uint64_t>(std::llround(v * 100.0));}
+
+    struct alignas(64) Shard {
+        std::atomic<double> realized{0};
+        std::atomic<int64_t> trades{0};
+    };
+
+    double startBalance;
+    alignas(64) std::atomic<uint64_t> book{0};
+    std::vector<Shard> shards;
+    PerSymbol<uint64_t> reserved{0};
+};
\ No newline at end of file
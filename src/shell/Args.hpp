@@ -11,6 +11,9 @@ inline long long parseArg<long long>(const std::string& s) {return std::stoll(s)
 template<>
 inline long parseArg<long>(const std::string& s) {return std::stol(s);}
 
+template<>
+inline uint64_t parseArg<uint64_t>(const std::string& s) {return std::stoull(s);}
+
 template<>
 inline int parseArg<int>(const std::string& s) {return std::stoi(s);}
 
@@ -35,6 +38,9 @@ struct ArgName<long long> {static constexpr auto *value = "long long";};
 template<>
 struct ArgName<long> {static constexpr auto *value = "long";};
 
+template<>
+struct ArgName<uint64_t> {static constexpr auto *value = "id";};
+
 template<>
 struct ArgName<int> {static constexpr auto *value = "int";};
 
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Shell.hpp>
+
+//? Stand-in for ImGuiTerminalShell in IBAT_HEADLESS builds: the same shell and commands, no render loop.
+class HeadlessShell {
+public:
+    Shell shell;
+
+    HeadlessShell() : shell("IBAT") {
+        const auto stop = [this](const std::vector<std::string> &) {shell.running = false;};
+        shell.registerCommand("exit", stop, "Exit the shell", Dispatch::Inline);
+        shell.registerCommand("quit", stop, "Exit the shell", Dispatch::Inline);
+    }
+
+    void Init() {}
+};
+
+//? Runs shell commands from a script, one per line, each to completion before the next.
+//? Blank lines and lines starting with '#' are skipped. A JSON line with the exit code and wall time
+//? of every command is written to timing. Returns the first non-zero command exit code (or the last
+//? one with keepGoing), 0 when every command succeeded.
+inline int RunScript(const Shell &shell, std::istream &script, std::ostream &timing, const bool keepGoing = false) {
+    const auto escape = [](const std::string &s) {
+        std::string out;
+        for (const char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    };
+
+    int result = 0;
+    std::string line;
+    for (int lineNo = 1; shell.running && std::getline(script, line); ++lineNo) {
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const int code = shell.executeCommandSync(line);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        timing << "{\"line\":" << lineNo << ",\"command\":\"" << escape(line) << "\",\"exit\":" << code
+               << ",\"ms\":" << std::fixed << std::setprecision(3) << ms << "}" << std::endl;
+
+        if (code != 0) {
+            result = code;
+            if (!keepGoing) break;
+        }
+    }
+    return result;
+}
+
+//? Entry point of the headless target.
+//? Usage: ibat [--script <file>|-] [--timing <file>] [--workers <n>] [--keep-going]
+//? Without --script, commands are read from stdin. Timing lines go to --timing, or stderr so that stdout
+//? carries only command output.
+inline int RunHeadless(const Shell &shell, const int argc, char** argv) {
+    std::string scriptPath = "-";
+    std::string timingPath;
+    bool keepGoing = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--script" && i + 1 < argc) scriptPath = argv[++i];
+        else if (a == "--timing" && i + 1 < argc) timingPath = argv[++i];
+        else if (a == "--workers" && i + 1 < argc) shell.jobs.SetWorkers(std::max(1, std::stoi(argv[++i])));
+        else if (a == "--keep-going") keepGoing = true;
+        else {
+            std::cerr << "Unknown argument: " << a << "\n"
+                      << "Usage: ibat [--script <file>|-] [--timing <file>] [--workers <n>] [--keep-going]\n";
+            return 64;
+        }
+    }
+
+    std::ofstream timingFile;
+    if (!timingPath.empty()) {
+        timingFile.open(timingPath);
+        if (!timingFile) {std::cerr << "Cannot open " << timingPath << "\n"; return 66;}
+    }
+    std::ostream &timing = timingPath.empty() ? std::cerr : timingFile;
+
+    if (scriptPath == "-") return RunScript(shell, std::cin, timing, keepGoing);
+
+    std::ifstream script(scriptPath);
+    if (!script) {std::cerr << "Cannot open " << scriptPath << "\n"; return 66;}
+    return RunScript(shell, script, timing, keepGoing);
+}
\ No newline at end of file
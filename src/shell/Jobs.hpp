@@ -0,0 +1,259 @@
+#pragma once
+
+#include <Common.hpp>
+
+enum class JobState {
+    Queued,
+    Running,
+    Done,
+    Failed,
+    Cancelled
+};
+
+inline const char* JobStateName(const JobState s) {
+    switch (s) {
+        case JobState::Queued:    return "queued";
+        case JobState::Running:   return "running";
+        case JobState::Done:      return "done";
+        case JobState::Failed:    return "failed";
+        case JobState::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+//? Thrown from a cancellation point to unwind a cancelled job.
+struct JobCancelled final : std::exception {
+    [[nodiscard]] const char* what() const noexcept override {return "job cancelled";}
+};
+
+//? Copyable handle on a job's cancel flag. Take it on the job thread (job::Token()) and hand it to any
+//? worker threads the job starts, they do not see job::Current. A default token is never cancelled.
+class CancelToken {
+public:
+    CancelToken() = default;
+    explicit CancelToken(std::shared_ptr<const std::atomic<bool>> flag) : flag(std::move(flag)) {}
+
+    [[nodiscard]] bool Cancelled() const {return flag && flag->load(std::memory_order_relaxed);}
+    void Check() const {if (Cancelled()) throw JobCancelled();}
+
+private:
+    std::shared_ptr<const std::atomic<bool>> flag;
+};
+
+//? Pool-owned job record. Only id, name, state, cancel and progress may be read without the pool lock,
+//? timings and error are written under it and read through JobPool::List()/Get() snapshots.
+struct Job {
+    uint64_t id = 0;
+    std::string name;
+    std::function<void()> fn;
+    std::atomic<JobState> state{JobState::Queued};
+    std::shared_ptr<std::atomic<bool>> cancel = std::make_shared<std::atomic<bool>>(false);
+    std::atomic<float> progress{0.f};
+    std::chrono::steady_clock::time_point queued{std::chrono::steady_clock::now()};
+    std::chrono::steady_clock::time_point started{};
+    std::chrono::steady_clock::time_point finished{};
+    std::string error;
+
+    [[nodiscard]] bool Finished() const {
+        const JobState s = state.load();
+        return s == JobState::Done || s == JobState::Failed || s == JobState::Cancelled;
+    }
+};
+
+//? Consistent copy of a job taken under the pool lock, for listing.
+struct JobInfo {
+    uint64_t id = 0;
+    std::string name;
+    JobState state = JobState::Queued;
+    float progress = 0.f;
+    std::chrono::steady_clock::time_point queued{};
+    std::chrono::steady_clock::time_point started{};
+    std::chrono::steady_clock::time_point finished{};
+    std::string error;
+
+    [[nodiscard]] bool Finished() const {
+        return state == JobState::Done || state == JobState::Failed || state == JobState::Cancelled;
+    }
+};
+
+//? Cooperative cancellation and progress for code running on a job's own thread.
+//? Outside of a job (e.g. direct calls during tests) these are no-ops.
+namespace job {
+    inline thread_local Job* Current = nullptr;
+
+    [[nodiscard]] inline bool Cancelled() {return Current && Current->cancel->load(std::memory_order_relaxed);}
+
+    inline void CancellationPoint() {if (Cancelled()) throw JobCancelled();}
+
+    inline void Progress(const float p) {if (Current) Current->progress.store(p, std::memory_order_relaxed);}
+
+    //& Cancel token of the current job, for threads started by it.
+    [[nodiscard]] inline CancelToken Token() {return Current ? CancelToken(Current->cancel) : CancelToken();}
+}
+
+//? Bounded worker pool behind the shell. Jobs get sequential ids, are queued FIFO and run on at most
+//? Workers() threads. Finished jobs are retained for listing until RetainFinished is exceeded.
+class JobPool {
+public:
+    explicit JobPool(const unsigned workers = std::max(1u, std::thread::hardware_concurrency() / 2)) {
+        SetWorkers(workers);
+    }
+
+    ~JobPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+            for (auto &j : jobs) *j->cancel = true;
+        }
+        cv.notify_all();
+        for (auto &t : threads) t.join();
+    }
+
+    JobPool(const JobPool&) = delete;
+    JobPool &operator=(const JobPool&) = delete;
+
+    size_t RetainFinished = 64;
+
+    uint64_t Submit(std::string name, std::function<void()> fn) {
+        auto j = std::make_shared<Job>();
+        {
+            std::lock_guard lock(mutex);
+            j->id = ++nextId;
+            j->name = std::move(name);
+            j->fn = std::move(fn);
+            queue.push_back(j);
+            jobs.push_back(j);
+            prune();
+        }
+        cv.notify_one();
+        return j->id;
+    }
+
+    //& Queued jobs are dropped immediately, running jobs stop at their next cancellation point.
+    bool Cancel(const uint64_t id) {
+        std::lock_guard lock(mutex);
+        const auto j = find(id);
+        if (!j || j->Finished()) return false;
+        *j->cancel = true;
+        if (j->state == JobState::Queued) {
+            std::erase(queue, j);
+            finish(*j, JobState::Cancelled);
+        }
+        return true;
+    }
+
+    //& Blocks until the job finishes, returns its final state (Failed for unknown ids).
+    JobState Wait(const uint64_t id) {
+        std::unique_lock lock(mutex);
+        const auto j = find(id);
+        if (!j) return JobState::Failed;
+        done.wait(lock, [&] {return j->Finished();});
+        return j->state;
+    }
+
+    void WaitAll() {
+        std::unique_lock lock(mutex);
+        done.wait(lock, [&] {
+            return std::ranges::all_of(jobs, [](const auto &j) {return j->Finished();});
+        });
+    }
+
+    [[nodiscard]] std::optional<JobInfo> Get(const uint64_t id) {
+        std::lock_guard lock(mutex);
+        const auto j = find(id);
+        if (!j) return std::nullopt;
+        return info(*j);
+    }
+
+    [[nodiscard]] std::vector<JobInfo> List() {
+        std::lock_guard lock(mutex);
+        std::vector<JobInfo> out;
+        out.reserve(jobs.size());
+        for (const auto &j : jobs) out.push_back(info(*j));
+        return out;
+    }
+
+    //& Grows the pool immediately, shrinking retires workers as they become idle.
+    void SetWorkers(const unsigned n) {
+        std::lock_guard lock(mutex);
+        target = std::max(1u, n);
+        while (active < target) {
+            ++active;
+            threads.emplace_back([this] {work();});
+        }
+        cv.notify_all();
+    }
+
+    [[nodiscard]] unsigned Workers() const {return target;}
+
+private:
+    void work() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            cv.wait(lock, [&] {return stopping || !queue.empty() || active > target;});
+            if (stopping || active > target) {--active; return;}
+
+            const auto j = queue.front();
+            queue.pop_front();
+            j->started = std::chrono::steady_clock::now();
+            j->state = JobState::Running;
+            lock.unlock();
+
+            JobState result = JobState::Done;
+            std::string error;
+            job::Current = j.get();
+            try {
+                j->fn();
+                if (*j->cancel) result = JobState::Cancelled;
+            } catch (const JobCancelled&) {
+                result = JobState::Cancelled;
+            } catch (const std::exception &e) {
+                error = e.what();
+                result = JobState::Failed;
+            } catch (...) {
+                error = "unknown exception";
+                result = JobState::Failed;
+            }
+            job::Current = nullptr;
+
+            lock.lock();
+            j->error = std::move(error);
+            finish(*j, result);
+        }
+    }
+
+    void finish(Job &j, const JobState s) {
+        j.finished = std::chrono::steady_clock::now();
+        j.fn = nullptr;
+        j.state = s;
+        done.notify_all();
+    }
+
+    static JobInfo info(const Job &j) {
+        return {j.id, j.name, j.state.load(), j.progress.load(), j.queued, j.started, j.finished, j.error};
+    }
+
+    std::shared_ptr<Job> find(const uint64_t id) {
+        for (auto &j : jobs) if (j->id == id) return j;
+        return nullptr;
+    }
+
+    void prune() {
+        size_t finished = std::ranges::count_if(jobs, [](const auto &j) {return j->Finished();});
+        for (auto it = jobs.begin(); it != jobs.end() && finished > RetainFinished;) {
+            if ((*it)->Finished()) {it = jobs.erase(it); --finished;}
+            else ++it;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable done;
+    std::deque<std::shared_ptr<Job>> queue;
+    std::deque<std::shared_ptr<Job>> jobs;
+    std::vector<std::thread> threads;
+    uint64_t nextId = 0;
+    unsigned target = 0;
+    unsigned active = 0;
+    bool stopping = false;
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Common.hpp>
+
+//? Bounded ring of fixed width log lines. Appending claims a slot with a single fetch_add and publishes it
+//? with a per-slot sequence number (seqlock), so writers never block each other or the renderer.
+//? Lines longer than Width are continued in following slots. Once full, the oldest lines are overwritten.
+class LogRing {
+public:
+    static constexpr size_t Width = 256;
+
+    explicit LogRing(const size_t lines = 1 << 15)
+        : cap(std::bit_ceil(std::max<size_t>(lines, 2))), mask(cap - 1), slots(new Slot[cap]) {}
+
+    void Append(std::string_view line) {
+        do {
+            const size_t n = std::min(line.size(), Width);
+            const uint64_t idx = head.fetch_add(1, std::memory_order_relaxed);
+            Slot &s = slots[idx & mask];
+            s.seq.store(2 * idx + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            s.len = static_cast<uint16_t>(n);
+            std::memcpy(s.text, line.data(), n);
+            s.seq.store(2 * idx + 2, std::memory_order_release);
+            line.remove_prefix(n);
+        } while (!line.empty());
+    }
+
+    //& Copies line idx into out, false if it is still being written or was already overwritten.
+    bool Read(const uint64_t idx, std::string &out) const {
+        const Slot &s = slots[idx & mask];
+        const uint64_t before = s.seq.load(std::memory_order_acquire);
+        if (before != 2 * idx + 2) return false;
+        const uint16_t len = std::min<uint16_t>(s.len, Width);
+        out.assign(s.text, len);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return s.seq.load(std::memory_order_relaxed) == before;
+    }
+
+    //& Index one past the newest line.
+    [[nodiscard]] uint64_t Head() const {return head.load(std::memory_order_acquire);}
+
+    //& Index of the oldest retained line.
+    [[nodiscard]] uint64_t Tail() const {
+        const uint64_t h = Head();
+        return std::max(base.load(std::memory_order_relaxed), h > cap ? h - cap : 0);
+    }
+
+    [[nodiscard]] size_t Capacity() const {return cap;}
+
+    void Clear() {base.store(Head(), std::memory_order_relaxed);}
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        uint16_t len = 0;
+        char text[Width]{};
+    };
+
+    const size_t cap;
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> base{0};
+};
\ No newline at end of file
@@ -1,16 +1,46 @@
 #pragma once
 
+#ifdef _WIN32
 #include <conio.h>
+#else
+#include <cstdio>
+#include <termios.h>
+#include <unistd.h>
+
+//? POSIX stand-in for conio's unbuffered, unechoed single character read.
+inline int _getch() {
+    termios old{};
+    tcgetattr(STDIN_FILENO, &old);
+    termios raw = old;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    const int c = getchar();
+    tcsetattr(STDIN_FILENO, TCSANOW, &old);
+    return c;
+}
+#endif
 
 #include <Common.hpp>
+#ifndef IBAT_HEADLESS
 #include <GUIWin.hpp>
+#endif
 #include <Args.hpp>
+#include <Jobs.hpp>
+
+//? How a command is run: queued on the job pool, inline on the calling thread, or on its own thread
+//? (for commands that block on other jobs, like wait).
+enum class Dispatch {
+    Pool,
+    Inline,
+    Detached
+};
 
 class Shell {
     struct Command {
         std::string name;
         std::function<void(const std::vector<std::string>&)> function;
         std::string description;
+        Dispatch dispatch = Dispatch::Pool;
     };
 
     std::vector<Command> commands;
@@ -18,6 +48,7 @@ class Shell {
 public:
     std::string prompt;
     bool running;
+    mutable JobPool jobs;
 
     explicit Shell(std::string  promptText = "Shell") :
         prompt(std::move(promptText)), running(true) {
@@ -28,7 +59,8 @@ public:
     void registerCommand(
         const std::string& name,
         const std::function<void(const std::vector<std::string>&)> &func,
-        const std::string& desc = ""
+        const std::string& desc = "",
+        const Dispatch dispatch = Dispatch::Pool
     ) {
         std::string fullDesc = desc;
         if constexpr(sizeof...(Args) > 0) {
@@ -48,7 +80,7 @@ public:
             func(args);
         };
 
-        commands.push_back({name, func, fullDesc});
+        commands.push_back({name, func, fullDesc, dispatch});
     }
 
     //& Regular member functions with args.
@@ -126,29 +158,74 @@ public:
         }
     }
 
-    void executeCommand(std::string& input) const {
-        std::ranges::transform(input, input.begin(),
-            [](const unsigned char c) -> uint8_t {return std::tolower(c);});
+    //& Runs the command to completion and returns an exit code: 0 done, 1 failed, 2 unknown command, 3 cancelled.
+    //& Pool commands go through the job pool; Inline and Detached ones (wait, jobs, ...) run on the calling
+    //& thread, since a wait queued behind the jobs it waits for would never be scheduled.
+    int executeCommandSync(std::string input) const {
+        std::string commandName;
+        std::vector<std::string> tokens;
+        const Command *cmd = parse(input, commandName, tokens);
+        if (!cmd) {
+            if (commandName.empty()) return 0;
+            std::cerr << "Unknown command: " << commandName << "\n";
+            return 2;
+        }
 
-        std::vector<std::string> tokens = tokenize(input);
-        if (tokens.empty()) return;
-        const std::string commandName = tokens[0];
-        for (int i = 0; i < tokens.size() - 1; ++i) {
-            tokens[i] = tokens[i + 1];
+        if (cmd->dispatch != Dispatch::Pool) {
+            try {
+                cmd->function(tokens);
+                return 0;
+            } catch (const JobCancelled&) {
+                return 3;
+            } catch (const std::exception &e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 1;
+            }
         }
 
-        tokens.pop_back();
+        const uint64_t id = jobs.Submit(input, [fn = cmd->function, tokens]() -> void {
+            fn(tokens);
+        });
+        switch (jobs.Wait(id)) {
+            case JobState::Done:      return 0;
+            case JobState::Cancelled: return 3;
+            default: {
+                if (const auto j = jobs.Get(id); j && !j->error.empty())
+                    std::cerr << "Error: " << j->error << "\n";
+                return 1;
+            }
+        }
+    }
 
-        for (const auto& cmd : commands) {
-            if (cmd.name == commandName) {
-                std::thread([&cmd, tokens]() -> void {
-                    cmd.function(tokens);
+    //& Dispatches the command and returns its job id, 0 if it did not go through the job pool.
+    uint64_t executeCommand(std::string& input) const {
+        std::string commandName;
+        std::vector<std::string> tokens;
+        const Command *cmd = parse(input, commandName, tokens);
+        if (!cmd) {
+            if (!commandName.empty())
+                std::cout << "Unknown command: " << commandName << ". Type 'help' for available commands.\n";
+            return 0;
+        }
+
+        switch (cmd->dispatch) {
+            case Dispatch::Inline:
+                cmd->function(tokens);
+                return 0;
+            case Dispatch::Detached:
+                std::thread([fn = cmd->function, tokens]() -> void {
+                    fn(tokens);
                 }).detach();
-                return;
+                return 0;
+            case Dispatch::Pool: {
+                const uint64_t id = jobs.Submit(input, [fn = cmd->function, tokens]() -> void {
+                    fn(tokens);
+                });
+                std::cout << "[" << id << "] " << input << "\n";
+                return id;
             }
         }
-
-        std::cout << "Unknown command: " << commandName << ". Type 'help' for available commands.\n";
+        return 0;
     }
 
     void stop() {
@@ -162,10 +239,69 @@ public:
     }
 
 private:
+    //? Shared front end of executeCommand and executeCommandSync: lowercases input in place, splits it and
+    //? looks the command up. args receives the tokens after the name. Returns nullptr for blank input (name
+    //? left empty) or an unknown command.
+    const Command *parse(std::string &input, std::string &name, std::vector<std::string> &args) const {
+        std::ranges::transform(input, input.begin(),
+            [](const unsigned char c) -> uint8_t {return std::tolower(c);});
+
+        args = tokenize(input);
+        if (args.empty()) return nullptr;
+        name = std::move(args.front());
+        args.erase(args.begin());
+
+        const auto cmd = std::ranges::find(commands, name, &Command::name);
+        return cmd == commands.end() ? nullptr : &*cmd;
+    }
+
     void setupBaseCommands() {
         registerCommand("help", [this](const std::vector<std::string>& args) -> void {
             showHelp();
-        }, "Show available commands");
+        }, "Show available commands", Dispatch::Inline);
+
+        registerCommand("jobs", [this](const std::vector<std::string>& args) -> void {
+            showJobs();
+        }, "List queued, running and recently finished jobs", Dispatch::Inline);
+
+        registerCommand<uint64_t>("cancel", [this](const std::vector<std::string>& args) -> void {
+            if (args.empty()) {std::cerr << "Usage: cancel <id>\n"; return;}
+            const uint64_t id = std::stoull(args[0]);
+            std::cout << (jobs.Cancel(id) ? "Cancelling job " : "No active job ") << id << "\n";
+        }, "Cancel a job, running jobs stop at their next cancellation point", Dispatch::Inline);
+
+        registerCommand<uint64_t>("wait", [this](const std::vector<std::string>& args) -> void {
+            if (args.empty()) {
+                jobs.WaitAll();
+                std::cout << "All jobs finished\n";
+                return;
+            }
+            const uint64_t id = std::stoull(args[0]);
+            std::cout << "Job " << id << " " << JobStateName(jobs.Wait(id)) << "\n";
+        }, "Wait for a job, or all jobs without an id", Dispatch::Detached);
+
+        registerCommand<int>("workers", [this](const std::vector<std::string>& args) -> void {
+            if (!args.empty()) jobs.SetWorkers(std::max(1, std::stoi(args[0])));
+            std::cout << "Job workers: " << jobs.Workers() << "\n";
+        }, "Show or set the number of job workers", Dispatch::Inline);
+    }
+
+    void showJobs() const {
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto &j : jobs.List()) {
+            const JobState s = j.state;
+            const auto end = j.Finished() ? j.finished : now;
+            const auto begin = s == JobState::Queued ? j.queued : j.started;
+            const double secs = std::chrono::duration<double>(end - begin).count();
+
+            std::cout << GREEN << "[" << j.id << "] " << RES << std::left << std::setw(10) << JobStateName(s)
+                      << std::right << std::fixed << std::setprecision(1) << std::setw(8) << secs << "s ";
+            if (s == JobState::Running && j.progress > 0)
+                std::cout << std::setw(5) << j.progress * 100.f << "% ";
+            std::cout << j.name;
+            if (!j.error.empty()) std::cout << " (" << j.error << ")";
+            std::cout << "\n";
+        }
     }
 
     static std::string getInput() {
@@ -173,10 +309,10 @@ private:
         std::string originalInput;
 
         while (true) {
-            if (const int c = _getch(); c == 13) { // Enter
+            if (const int c = _getch(); c == 13 || c == 10) { // Enter
                 std::cout << "\n";
                 break;
-            } else if (c == 8) { // Backspace
+            } else if (c == 8 || c == 127) { // Backspace
                 if (!buffer.empty()) {
                     buffer.pop_back();
                     std::cout << "\b \b";
@@ -233,27 +369,53 @@ private:
 };
 
 // *** IMGUI -----------------------------------------------------------------------------------------------------
+#ifndef IBAT_HEADLESS
 #include <Ansi.hpp>
+#include <LogRing.hpp>
 
 const std::string COL = "\033[36m";
 
+//? Each thread assembles its own line and appends it to the ring once complete, no lock is taken per character.
 class TerminalBuffer final : public std::streambuf {
 public:
-    std::ostringstream buffer;
-    std::mutex mutex;
+    LogRing ring;
 
 protected:
     int overflow(const int c) override {
-        std::lock_guard lock(mutex);
-        buffer.put(static_cast<char>(c));
+        if (c == traits_type::eof()) return traits_type::not_eof(c);
+        if (c == '\n') publish();
+        else pending.push_back(static_cast<char>(c));
         return c;
     }
+
+    std::streamsize xsputn(const char* s, const std::streamsize n) override {
+        std::string_view text(s, static_cast<size_t>(n));
+        for (size_t nl; (nl = text.find('\n')) != std::string_view::npos; text.remove_prefix(nl + 1)) {
+            pending.append(text.substr(0, nl));
+            publish();
+        }
+        pending.append(text);
+        return n;
+    }
+
+    int sync() override {
+        if (!pending.empty()) publish();
+        return 0;
+    }
+
+private:
+    void publish() {
+        ring.Append(pending);
+        pending.clear();
+    }
+
+    static inline thread_local std::string pending;
 };
 
 class ImGuiTerminalShell {
     TerminalBuffer      outBuf;
     char                inputLine[256];
-    std::string         outputText;
+    std::string         lineText;
     bool                scrollToBottom = true;
 public:
     Shell               shell;
@@ -262,25 +424,21 @@ public:
     ImGuiTerminalShell()
         : inputLine{}, shell(COL + "IBAT" + RES), Hook(0) {
         shell.registerCommand("clear", [this](const std::vector<std::string> &) {
-            {
-                std::lock_guard<std::mutex> lock(outBuf.mutex);
-                outBuf.buffer.str("");
-                outBuf.buffer.clear();
-            }
+            outBuf.ring.Clear();
             std::cout << shell.prompt << "> \n";
             std::cout.flush();
             this->scrollToBottom = true;
-        }, "Clear the screen");
+        }, "Clear the screen", Dispatch::Inline);
 
         shell.registerCommand("exit", [this](const std::vector<std::string> &args) {
             shell.running = false;
             GuiHooks::unregisterRenderCallback(Hook);
-        }, "Exit the shell");
+        }, "Exit the shell", Dispatch::Inline);
 
         shell.registerCommand("quit", [this](const std::vector<std::string> &args) {
             shell.running = false;
             GuiHooks::unregisterRenderCallback(Hook);
-        }, "Exit the shell");
+        }, "Exit the shell", Dispatch::Inline);
     }
 
     void Init() {
@@ -288,11 +446,9 @@ public:
         std::cerr.rdbuf(&outBuf);
     }
 
-void Render() {
-        {
-            std::lock_guard lock(outBuf.mutex);
-            outputText = outBuf.buffer.str();
-        }
+    void Render() {
+        const uint64_t tail = outBuf.ring.Tail();
+        const uint64_t head = outBuf.ring.Head();
 
         const ImGuiIO& io = ImGui::GetIO();
 
@@ -312,7 +468,15 @@ void Render() {
                     const float max_scroll     = ImGui::GetScrollMaxY();
                     const bool at_bottom = (max_scroll <= 0.0f) || (current_scroll >= max_scroll - 1.0f);
 
-                    ImGuiAnsiText(outputText);
+                    //? Only the visible lines are copied out of the ring and rendered.
+                    ImGuiListClipper clipper;
+                    clipper.Begin(static_cast<int>(head - tail));
+                    while (clipper.Step()) {
+                        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                            if (!outBuf.ring.Read(tail + i, lineText)) lineText.clear();
+                            ImGuiAnsiText(lineText);
+                        }
+                    }
 
                     if (scrollToBottom) {
                         ImGui::SetScrollHereY(1.0f);
@@ -362,3 +526,4 @@ void Render() {
 
     }
 };
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <PerSymbol.hpp>
+#include <AsyncLog.hpp>
+
+//? Append-only journal of incremental strategy checkpoints.
+//? Each record holds only the dirty symbols of each member and is framed by length and checksum,
+//? so a record torn by a crash is detected and ignored on replay. The journal is compacted into a
+//? full snapshot at day end.
+struct CheckpointJournal {
+    explicit CheckpointJournal(std::string path) : file(std::move(path)) {}
+
+    struct Frame {
+        uint64_t length = 0;
+        uint64_t checksum = 0;
+    };
+
+    //& Appends the dirty state of every member and clears the dirty marks, returns the record size.
+    //! Must run at a quiescent point (e.g. between bars) so no reader thread writes members mid-record.
+    size_t Append(const std::vector<IPerSymbol*> &members, const int64_t time) {
+        BinWriter w;
+        w.val(SchemaHash(members));
+        w.val(time);
+        uint32_t touched = 0;
+        for (const auto *m : members) touched += m->DirtyCount() > 0;
+        w.val(touched);
+        for (uint32_t i = 0; i < members.size(); ++i) {
+            if (members[i]->DirtyCount() == 0) continue;
+            w.val(i);
+            members[i]->SaveDirty(w);
+            members[i]->ClearDirty();
+        }
+
+        const auto &buf = w.Buffer();
+        Checksum64 sum;
+        sum.update(buf.data(), buf.size());
+        const Frame f{buf.size(), sum.digest()};
+
+        std::ofstream out(file, std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char*>(&f), sizeof(f));
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        out.flush();
+        if (!out) throw std::runtime_error("CheckpointJournal: failed to append to " + file);
+        ++Records;
+        return buf.size();
+    }
+
+    //& Applies every intact record newer than after in order onto the members, returns the time of the last
+    //& one applied (0 if none). Records at or before after are already folded into the snapshot being
+    //& replayed onto, they survive when a crash hits between SaveSnapshot and Truncate.
+    int64_t Replay(const std::vector<IPerSymbol*> &members, const int64_t after = std::numeric_limits<int64_t>::min()) const {
+        std::ifstream in(file, std::ios::binary | std::ios::ate);
+        if (!in) return 0;
+        uint64_t remaining = static_cast<uint64_t>(in.tellg());
+        in.seekg(0);
+
+        const uint64_t schema = SchemaHash(members);
+        int64_t last = 0;
+        bool torn = false;
+        Frame f;
+        while (remaining >= sizeof(f) && in.read(reinterpret_cast<char*>(&f), sizeof(f))) {
+            remaining -= sizeof(f);
+            if (f.length > remaining) {torn = true; break;} // Torn or corrupt length, never allocate past the file
+            remaining -= f.length;
+            std::vector<char> buf(f.length);
+            if (!in.read(buf.data(), static_cast<std::streamsize>(f.length))) {torn = true; break;}
+            Checksum64 sum;
+            sum.update(buf.data(), buf.size());
+            if (sum.digest() != f.checksum) {torn = true; break;}
+
+            BinReader r(std::move(buf));
+            uint64_t recSchema;
+            int64_t time;
+            uint32_t touched;
+            r.val(recSchema);
+            if (recSchema != schema) throw std::runtime_error("CheckpointJournal: schema mismatch in " + file);
+            r.val(time);
+            if (time <= after) continue;
+            r.val(touched);
+            for (uint32_t t = 0; t < touched && r.ok(); ++t) {
+                uint32_t i;
+                r.val(i);
+                if (i >= members.size()) throw std::runtime_error("CheckpointJournal: member out of range in " + file);
+                members[i]->LoadDirty(r);
+            }
+            last = time;
+        }
+        if (torn || remaining > 0) IBAT_WARN("CheckpointJournal: ignored a torn record, replayed up to time {}", last);
+        return last;
+    }
+
+    //& Drops all records, called once the state they describe is in a full snapshot.
+    void Truncate() {
+        std::ofstream(file, std::ios::binary | std::ios::trunc);
+        Records = 0;
+    }
+
+    [[nodiscard]] const std::string &Path() const {return file;}
+    size_t Records = 0;
+
+private:
+    std::string file;
+};
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <BOT.hpp>
+
+//? Reduction used when collapsing a feature's base resolution into a coarser one.
+enum class Reduce : uint8_t {
+    Mean,
+    Sum,
+    Last,
+    Min,
+    Max
+};
+
+//? Builds every collapsed resolution of every feature in a single pass over each base sequence.
+//? All outputs live in one preallocated buffer, [feature][level][step], sized by Layout().
+template<size_t Levels>
+struct CollapseEngine {
+    explicit CollapseEngine(const std::array<int, Levels> &factors) {SetFactors(factors);}
+
+    //& Replaces the collapse factor of every level, all must be positive.
+    void SetFactors(const std::array<int, Levels> &factors) {
+        for (const int f : factors)
+            if (f <= 0) throw std::runtime_error("CollapseEngine: factors must be positive");
+        Factors = factors;
+    }
+
+    //& Number of collapsed steps produced from len base steps at the given level.
+    [[nodiscard]] size_t Steps(const size_t len, const size_t level) const {
+        const auto f = static_cast<size_t>(Factors[level]);
+        return (len + f - 1) / f;
+    }
+
+    //& Offsets of each (feature, level) output within the shared buffer, last entry is the total size.
+    [[nodiscard]] std::vector<size_t> Layout(const std::vector<size_t> &lengths) const {
+        std::vector<size_t> offsets;
+        offsets.reserve(lengths.size() * Levels + 1);
+        size_t off = 0;
+        for (const size_t len : lengths)
+            for (size_t l = 0; l < Levels; ++l) {
+                offsets.push_back(off);
+                off += Steps(len, l);
+            }
+        offsets.push_back(off);
+        return offsets;
+    }
+
+    /// @param base Base resolution sequence of each feature.
+    /// @param reduce Reduction of each feature.
+    /// @param out Buffer of at least Layout(...).back() floats.
+    /// @param offsets Result of Layout() for the same base lengths.
+    void Run(const std::vector<const std::vector<float>*> &base,
+             const std::vector<Reduce> &reduce,
+             float* out, const std::vector<size_t> &offsets) const {
+        for (size_t f = 0; f < base.size(); ++f) {
+            std::array<float*, Levels> dst;
+            for (size_t l = 0; l < Levels; ++l)
+                dst[l] = out + offsets[f * Levels + l];
+            collapse(*base[f], reduce[f], dst);
+        }
+    }
+
+private:
+    std::array<int, Levels> Factors{};
+
+    //? All levels are reduced from the same read of each base value.
+    void collapse(const std::vector<float> &seq, const Reduce r, std::array<float*, Levels> &dst) const {
+        const size_t len = seq.size();
+        std::array<float, Levels> acc{};
+        std::array<int, Levels> fill{};
+        std::array<size_t, Levels> pos{};
+
+        for (size_t t = 0; t < len; ++t) {
+            const float v = seq[t];
+            for (size_t l = 0; l < Levels; ++l) {
+                float &a = acc[l];
+                if (fill[l] == 0) a = v;
+                else switch (r) {
+                    case Reduce::Mean:
+                    case Reduce::Sum:  a += v; break;
+                    case Reduce::Last: a = v; break;
+                    case Reduce::Min:  a = std::min(a, v); break;
+                    case Reduce::Max:  a = std::max(a, v); break;
+                }
+
+                if (++fill[l] == Factors[l] || t + 1 == len) {
+                    dst[l][pos[l]++] = r == Reduce::Mean ? a / static_cast<float>(fill[l]) : a;
+                    fill[l] = 0;
+                }
+            }
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Serial.hpp>
+#include <AsyncLog.hpp>
+
+//? Identity of one computed per-day feature sequence.
+//? Any change to the feature's parameters, the day's bars or the lookback bars warming it produces a new key.
+struct FeatureKey {
+    std::string feature;
+    std::string params;     // Fingerprint of the SetVar parameters the feature depends on
+    std::string symbol;
+    int64_t day = 0;
+    uint64_t dataVersion = 0;
+
+    [[nodiscard]] uint64_t Hash() const {
+        return Fnv1a().str(feature).str(params).str(symbol).val(day).val(dataVersion).h;
+    }
+
+    //& Content hash of the bars a day's sequence is built from, so revised or backfilled bars miss the cache.
+    template<bar_record B>
+    static uint64_t DataHash(const std::span<const B> bars) {
+        Fnv1a h;
+        h.val(static_cast<uint64_t>(bars.size()));
+        for (const auto &b : bars)
+            h.str(b.time).val(b.open).val(b.high).val(b.low).val(b.close).val(b.volume);
+        return h.h;
+    }
+};
+
+//? On-disk content addressed store of per-day feature sequences.
+//? Layout: <root>/<feature>/<hash>.seq, so a feature can be purged without touching the rest.
+struct FeatureCache {
+    explicit FeatureCache(std::filesystem::path dir = "cache/features") : root(std::move(dir)) {}
+
+    bool Enabled = true;
+
+    [[nodiscard]] std::filesystem::path PathFor(const FeatureKey &k) const {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(k.Hash()));
+        return root / k.feature / (std::string(name) + ".seq");
+    }
+
+    [[nodiscard]] bool Contains(const FeatureKey &k) const {
+        return Enabled && std::filesystem::exists(PathFor(k));
+    }
+
+    //& Reads the cached sequence into out, returns false on miss or if the entry belongs to another key.
+    bool Get(const FeatureKey &k, std::vector<float> &out) const {
+        if (!Enabled) return false;
+        const auto p = PathFor(k);
+        if (!std::filesystem::exists(p)) return false;
+
+        try {
+            BinReader r(p.string());
+            uint64_t hash;
+            r.val(hash);
+            if (hash != k.Hash()) return false;
+            r.readValue(out);
+            if (!r.ok()) return false;
+        } catch (const std::runtime_error&) { // Truncated, corrupt or from a newer version, rebuilt
+            return false;
+        }
+
+        ++hits;
+        return true;
+    }
+
+    //& Writes to a per-process unique temporary file and commits it by rename, so concurrent builders in
+    //& any process never observe partial entries. A failed write leaves no entry, the next build recomputes.
+    //? Not fsynced: an entry torn by a crash fails the hash or length check in Get and is simply rebuilt.
+    void Put(const FeatureKey &k, const std::vector<float> &seq) const {
+        if (!Enabled) return;
+        const auto p = PathFor(k).string();
+        std::error_code ec;
+        std::filesystem::create_directories(PathFor(k).parent_path(), ec);
+        const std::string tmp = TempPath(p);
+        bool ok;
+        {
+            BinWriter w(tmp);
+            w.val(k.Hash());
+            w.writeValue(seq);
+            w.Close();
+            ok = w.ok();
+        }
+        if (ok) std::filesystem::rename(tmp, p, ec);
+        if (!ok || ec) {
+            std::filesystem::remove(tmp, ec);
+            IBAT_WARN("FeatureCache: could not store an entry, it is recomputed on the next build");
+            return;
+        }
+        ++stores;
+    }
+
+    //& Returns the cached sequence or computes and stores it.
+    template<typename F>
+    std::vector<float> &GetOrCompute(const FeatureKey &k, std::vector<float> &out, F &&compute) const {
+        if (Get(k, out)) return out;
+        ++misses;
+        out = compute();
+        Put(k, out);
+        return out;
+    }
+
+    void Purge(const std::string &feature) const {
+        std::error_code ec;
+        std::filesystem::remove_all(root / feature, ec);
+    }
+
+    void PrintStats() const {
+        ibat::sout << "FeatureCache hits: " << hits << " misses: " << misses << " stores: " << stores << std::endl;
+    }
+
+    mutable std::atomic<uint64_t> hits{0};
+    mutable std::atomic<uint64_t> misses{0};
+    mutable std::atomic<uint64_t> stores{0};
+
+private:
+    std::filesystem::path root;
+};
\ No newline at end of file
@@ -51,6 +51,20 @@
         f.CollapsedNormalizersSym = &name##_i_sym_coll_norm; \
         f.nm = #name; \
         return f; \
+    }(); \
+    bool name##_slot_hook = [&]{ \
+        this->SlotHooks.push_back([this](const size_t slots, const int sym) { \
+            name##_sym_norm.Grow(slots); \
+            name##_sym_norm.ResetSym(sym); \
+            name##_i_sym_norm.Grow(slots); \
+            name##_i_sym_norm[sym] = &name##_sym_norm[sym]; \
+            name##_sym_coll_norm.Grow(slots); \
+            name##_sym_coll_norm.ResetSym(sym); \
+            name##_i_sym_coll_norm.Grow(slots); \
+            for (int c = 0; c < this->NumCollapsed; ++c) \
+                name##_i_sym_coll_norm[sym][c] = &name##_sym_coll_norm[sym][c]; \
+        }); \
+        return true; \
     }();
 
 /// Integrates a member as a PerSymbol<T> object to represent a sequence label into training data processing.
@@ -74,6 +88,15 @@
         l.NormalizersSym = &name##_i_sym_norm; \
         l.nm = #name; \
         return l; \
+    }(); \
+    bool name##_slot_hook = [&]{ \
+        this->SlotHooks.push_back([this](const size_t slots, const int sym) { \
+            name##_sym_norm.Grow(slots); \
+            name##_sym_norm.ResetSym(sym); \
+            name##_i_sym_norm.Grow(slots); \
+            name##_i_sym_norm[sym] = &name##_sym_norm[sym]; \
+        }); \
+        return true; \
     }();
 
 /// Integrates a member as a PerSymbol<T> object to represent a sequence label associated with an output of classes into training data processing.
@@ -97,6 +120,15 @@
         l.NormalizersSym = &name##_i_sym_norm; \
         l.nm = #name; \
         return l; \
+    }(); \
+    bool name##_slot_hook = [&]{ \
+        this->SlotHooks.push_back([this](const size_t slots, const int sym) { \
+            name##_sym_norm.Grow(slots); \
+            name##_sym_norm.ResetSym(sym); \
+            name##_i_sym_norm.Grow(slots); \
+            name##_i_sym_norm[sym] = &name##_sym_norm[sym]; \
+        }); \
+        return true; \
     }();
 
 #define EMBEDDED(name, ...) \
@@ -121,4 +153,15 @@
 /// @param ... Optional arguments to be passed to the derived indicator's constructor.
 #define INDICATOR(name, indicator, ...) \
     std::unique_ptr<indicator> name##_obj = std::make_unique<indicator>(__VA_ARGS__); \
+    IIndicator* name = name##_obj->Init(this, #name);
+
+/// Integrates an indicator shared with the other strategies of the StrategySet declaring the same type and arguments.
+/// The instance is stepped once per bar and symbol (see IndicatorRegistry) and read by all holders.
+/// Outside a StrategySet the indicator is private to the strategy.
+/// @param name Name of the IIndicator* member that will be integrated.
+/// @param indicator IIndicator derived type to be shared.
+/// @param ... Optional arguments to be passed to the derived indicator's constructor, part of the sharing key.
+#define SHARED_INDICATOR(name, indicator, ...) \
+    std::unique_ptr<SharedIndicator> name##_obj = \
+        std::make_unique<SharedIndicator>(IndicatorRegistry::Make<indicator>(__VA_ARGS__)); \
     IIndicator* name = name##_obj->Init(this, #name);
\ No newline at end of file
@@ -20,6 +20,9 @@ struct ISequenceFeature : ITrainingData {
     virtual std::vector<float> &Get(int sym) = 0;
     std::vector<INormalizer*> CollapsedNormalizersG{};
     PerSymbol<std::vector<INormalizer*>>* CollapsedNormalizersSym{};
+    Reduce CollapseReduce = Reduce::Mean;
+//? SetVar parameters the feature depends on for cache keys, empty means every parameter.
+    std::vector<const IPerSymbol*> Params{};
 };
 
 struct ILabel : ITrainingData {
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <BOT.hpp>
+
+//? Append-only chart series with a min/max decimation pyramid maintained on push_back.
+//? Level 0 is the raw data; level k holds one bucket per Fanout^k samples with the extremes and their indices,
+//? so any visible range can be drawn with about maxPoints points regardless of how many bars it spans.
+//? Drop-in for the std::vector<double> chart buffers (push_back, size, operator[], data, clear).
+//? With a RawBudget only the newest raw samples are kept, older ranges are drawn from the pyramid alone, which
+//? costs about 3.4 bytes per sample instead of 8. operator[] is then valid from Dropped(), data/begin/end
+//? cover the kept samples only.
+class LodSeries {
+public:
+    static constexpr size_t Fanout = 8;
+
+    size_t RawBudget = 0; // Raw samples kept, 0 keeps them all
+
+    struct Bucket {
+        double min, max;
+        uint32_t minIdx, maxIdx;
+    };
+
+    void push_back(const double v) {
+        const auto idx = static_cast<uint32_t>(count++);
+        raw.push_back(v);
+
+        size_t span = Fanout;
+        for (auto &lvl : levels) {
+            add(lvl, span, idx, v);
+            span *= Fanout;
+        }
+        // Levels appear once they would hold more than one bucket, the one below still covers every sample
+        if (count > span) {
+            levels.emplace_back();
+            if (levels.size() == 1)
+                for (size_t i = 0; i < raw.size(); ++i) add(levels.back(), span, static_cast<uint32_t>(i), raw[i]);
+            else
+                fold(levels.back(), levels[levels.size() - 2]);
+        }
+        // Trimmed in batches so the erase is amortized, never before the first level exists
+        if (const size_t keep = std::max(RawBudget, Fanout * Fanout); RawBudget && raw.size() >= 2 * keep) {
+            const size_t drop = raw.size() - keep;
+            raw.erase(raw.begin(), raw.begin() + static_cast<std::ptrdiff_t>(drop));
+            dropped += drop;
+        }
+    }
+
+    void reserve(const size_t n) {raw.reserve(RawBudget ? std::min(n, 2 * RawBudget) : n);}
+    void clear() {raw.clear(); levels.clear(); count = 0; dropped = 0;}
+
+    [[nodiscard]] size_t size() const {return count;}
+    [[nodiscard]] bool empty() const {return count == 0;}
+    //? Index of the oldest raw sample still kept.
+    [[nodiscard]] size_t Dropped() const {return dropped;}
+    [[nodiscard]] const double &operator[](const size_t i) const {return raw[i - dropped];}
+    [[nodiscard]] const double &back() const {return raw.back();}
+    [[nodiscard]] const double *data() const {return raw.data();}
+    [[nodiscard]] auto begin() const {return raw.begin();}
+    [[nodiscard]] auto end() const {return raw.end();}
+
+    [[nodiscard]] size_t Levels() const {return levels.size() + 1;}
+
+    //& Indices and values covering [i0, i1) with at most ~maxPoints points, extremes kept in index order.
+    /// @param outIdx Sample indices, map through the matching time series for the x axis
+    void Query(size_t i0, size_t i1, const size_t maxPoints,
+               std::vector<uint32_t> &outIdx, std::vector<double> &outVal) const {
+        outIdx.clear();
+        outVal.clear();
+        i1 = std::min(i1, count);
+        if (i0 >= i1) return;
+
+        size_t k = 0, span = 1;
+        while (k < levels.size() && (2 * (i1 - i0) / span > maxPoints || (k == 0 && i0 < dropped))) {++k; span *= Fanout;}
+
+        if (k == 0) {
+            for (size_t i = i0; i < i1; ++i) {
+                const double v = raw[i - dropped];
+                if (std::isnan(v)) continue;
+                outIdx.push_back(static_cast<uint32_t>(i));
+                outVal.push_back(v);
+            }
+            return;
+        }
+
+        const auto &lvl = levels[k - 1];
+        const size_t last = std::min((i1 - 1) / span, lvl.size() - 1);
+        outIdx.reserve(2 * (last - i0 / span + 1));
+        outVal.reserve(2 * (last - i0 / span + 1));
+        for (size_t b = i0 / span; b <= last; ++b) {
+            const Bucket &e = lvl[b];
+            if (std::isnan(e.min)) continue;
+            const bool minFirst = e.minIdx <= e.maxIdx;
+            outIdx.push_back(minFirst ? e.minIdx : e.maxIdx);
+            outVal.push_back(minFirst ? e.min : e.max);
+            if (e.minIdx == e.maxIdx) continue;
+            outIdx.push_back(minFirst ? e.maxIdx : e.minIdx);
+            outVal.push_back(minFirst ? e.max : e.min);
+        }
+    }
+
+    //& Same as Query but over the time range [t0, tN] of a sorted time series aligned with this one.
+    void QueryTime(const std::vector<double> &times, const double t0, const double tN, const size_t maxPoints,
+                   std::vector<double> &outX, std::vector<double> &outY) const {
+        const size_t n = std::min(times.size(), count);
+        const auto lo = static_cast<size_t>(std::lower_bound(times.begin(), times.begin() + n, t0) - times.begin());
+        const auto hi = static_cast<size_t>(std::upper_bound(times.begin(), times.begin() + n, tN) - times.begin());
+        Query(lo, hi, maxPoints, scratch, outY);
+        outX.resize(scratch.size());
+        for (size_t i = 0; i < scratch.size(); ++i) outX[i] = times[scratch[i]];
+    }
+
+private:
+    static void add(std::vector<Bucket> &lvl, const size_t span, const uint32_t idx, const double v) {
+        if (idx % span == 0) {
+            lvl.push_back({v, v, idx, idx});
+            return;
+        }
+        if (std::isnan(v)) return;
+        Bucket &b = lvl.back();
+        if (std::isnan(b.min) || v < b.min) {b.min = v; b.minIdx = idx;}
+        if (std::isnan(b.max) || v > b.max) {b.max = v; b.maxIdx = idx;}
+    }
+
+    //& Builds a level from the one below it, Fanout buckets per bucket, the same result as adding each sample.
+    static void fold(std::vector<Bucket> &lvl, const std::vector<Bucket> &below) {
+        for (size_t i = 0; i < below.size(); ++i) {
+            const Bucket &e = below[i];
+            if (i % Fanout == 0) {
+                lvl.push_back(e);
+                continue;
+            }
+            Bucket &b = lvl.back();
+            if (!std::isnan(e.min) && (std::isnan(b.min) || e.min < b.min)) {b.min = e.min; b.minIdx = e.minIdx;}
+            if (!std::isnan(e.max) && (std::isnan(b.max) || e.max > b.max)) {b.max = e.max; b.maxIdx = e.maxIdx;}
+        }
+    }
+
+    std::vector<double> raw;
+    size_t count = 0;   // Samples pushed
+    size_t dropped = 0; // Samples no longer in raw
+    std::vector<std::vector<Bucket>> levels;
+    mutable std::vector<uint32_t> scratch;
+};
+
+//? Price and volume history of the charted symbol for the plot hooks, stored only as pyramids plus the time
+//? axis. Replaces handing the hooks the full std::vector<Bar>: closes, highs, lows and volumes are decimated
+//? per visible range and the bars themselves need not be kept for charting. The time axis stays raw since
+//? every returned index maps through it.
+struct PriceChart {
+    std::vector<double> Times; // x axis shared by every series
+    LodSeries Close;
+    LodSeries High;
+    LodSeries Low;
+    LodSeries Volume;
+
+    void push_back(const double t, const Bar &b) {
+        Times.push_back(t);
+        Close.push_back(b.close);
+        High.push_back(b.high);
+        Low.push_back(b.low);
+        Volume.push_back(DecimalFunctions::decimalToDouble(b.volume));
+    }
+
+    //& Raw samples kept per series, see LodSeries::RawBudget.
+    void KeepRaw(const size_t n) {Close.RawBudget = High.RawBudget = Low.RawBudget = Volume.RawBudget = n;}
+
+    void clear() {
+        Times.clear();
+        Close.clear();
+        High.clear();
+        Low.clear();
+        Volume.clear();
+    }
+
+    [[nodiscard]] size_t size() const {return Times.size();}
+    [[nodiscard]] bool empty() const {return Times.empty();}
+
+    //& Decimated points of one of the series over the time range [t0, tN].
+    void Query(const LodSeries &series, const double t0, const double tN, const size_t maxPoints,
+               std::vector<double> &outX, std::vector<double> &outY) const {
+        series.QueryTime(Times, t0, tN, maxPoints, outX, outY);
+    }
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Serial.hpp>
+#include <Universe.hpp>
 
 template <typename T>
 constexpr bool is_bool = std::is_same_v<T,bool>;
@@ -24,25 +25,152 @@ struct IPerSymbol {
     virtual void ResetSym(int sym) = 0;
     virtual void ResetAll() = 0;
     virtual void PrintDef() = 0;
+    [[nodiscard]] virtual std::string DefString() const {return "";}
     virtual void Save(BinWriter& w) const {}
     virtual void Load(BinReader& r) {}
+    [[nodiscard]] virtual size_t TypeSize() const {return 0;}
+    [[nodiscard]] virtual double Sum() const {return 0;}
+    virtual void SaveDirty(BinWriter& w) const {}
+    virtual void LoadDirty(BinReader& r) {}
+    virtual void ClearDirty() {}
+    [[nodiscard]] virtual size_t DirtyCount() const {return 0;}
+    virtual void Grow(size_t n) {}
     std::string Name() const {return nm;}
     std::string nm;
 };
 
+//? Stable per-symbol storage: lazily allocated chunks whose capacity is reserved up front, so growing the
+//? universe never moves or reallocates the values of existing symbols and readers of other symbols need no
+//? lock. Slots are only constructed up to the logical size. The first InlineChunks chunk pointers live in the
+//? object, the overflow table is only allocated for universes past InlineChunks * ChunkSize symbols.
+//! Growth is single writer (the thread changing the universe).
+template<typename T>
+class SymbolChunks {
+public:
+    static constexpr size_t ChunkBits = 8;
+    static constexpr size_t ChunkSize = size_t{1} << ChunkBits;
+    static constexpr size_t Mask = ChunkSize - 1;
+    static constexpr size_t MaxChunks = SymbolUniverse::MaxSlots / ChunkSize;
+    static constexpr size_t InlineChunks = 16;
+
+    struct Chunk {
+        Chunk() {vals.reserve(ChunkSize);}
+        Chunk(const Chunk &o) : dirty(o.dirty) {
+            vals.reserve(ChunkSize);
+            vals.insert(vals.end(), o.vals.begin(), o.vals.end());
+        }
+        std::vector<T> vals;
+        std::array<uint8_t, ChunkSize> dirty{};
+    };
+
+    SymbolChunks() = default;
+    ~SymbolChunks() {release();}
+
+    SymbolChunks(const SymbolChunks &o) {*this = o;}
+    SymbolChunks &operator=(const SymbolChunks &o) {
+        if (this == &o) return *this;
+        release();
+        const size_t count = o.chunks();
+        if (count > InlineChunks) overflow.store(new std::atomic<Chunk*>[MaxChunks - InlineChunks](), std::memory_order_release);
+        for (size_t c = 0; c < count; ++c) slot(c).store(new Chunk(*o.chunk(c)), std::memory_order_release);
+        allocated.store(count, std::memory_order_release);
+        n.store(o.size(), std::memory_order_release);
+        return *this;
+    }
+
+    //& Grows to at least count slots (new slots hold def), shrinking only lowers the logical size.
+    void resize(const size_t count, const T &def) {
+        if (count > MaxChunks * ChunkSize) throw std::runtime_error("SymbolChunks: more than MaxSlots symbols");
+        const size_t need = (count + Mask) >> ChunkBits;
+        if (need > InlineChunks && !overflow.load(std::memory_order_acquire))
+            overflow.store(new std::atomic<Chunk*>[MaxChunks - InlineChunks](), std::memory_order_release);
+        for (size_t c = allocated.load(std::memory_order_relaxed); c < need; ++c) {
+            slot(c).store(new Chunk(), std::memory_order_release);
+            allocated.store(c + 1, std::memory_order_release);
+        }
+        for (size_t c = 0; c < need; ++c) {
+            auto &vals = chunk(c)->vals;
+            const size_t want = std::min(ChunkSize, count - (c << ChunkBits));
+            while (vals.size() < want) vals.push_back(def);
+        }
+        n.store(count, std::memory_order_release);
+    }
+
+    [[nodiscard]] size_t size() const {return n.load(std::memory_order_acquire);}
+    [[nodiscard]] size_t chunks() const {return allocated.load(std::memory_order_acquire);}
+
+    [[nodiscard]] Chunk *chunk(const size_t c) const {return const_cast<SymbolChunks*>(this)->slot(c).load(std::memory_order_acquire);}
+
+    decltype(auto) operator[](const size_t i) {return chunk(i >> ChunkBits)->vals[i & Mask];}
+    decltype(auto) operator[](const size_t i) const {
+        const Chunk *c = chunk(i >> ChunkBits);
+        return c->vals[i & Mask];
+    }
+    uint8_t &dirty(const size_t i) {return chunk(i >> ChunkBits)->dirty[i & Mask];}
+    [[nodiscard]] uint8_t dirty(const size_t i) const {return chunk(i >> ChunkBits)->dirty[i & Mask];}
+
+    //& Calls f(chunk, first symbol, count) over the live prefix of every chunk.
+    template<typename F>
+    void forEachChunk(F &&f) const {
+        const size_t total = size();
+        for (size_t base = 0; base < total; base += ChunkSize)
+            f(*chunk(base >> ChunkBits), base, std::min(ChunkSize, total - base));
+    }
+
+    template<typename S>
+    struct Iter {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(std::declval<S&>()[0]);
+        using pointer = void;
+
+        S *s = nullptr;
+        size_t i = 0;
+        reference operator*() const {return (*s)[i];}
+        Iter &operator++() {++i; return *this;}
+        Iter operator++(int) {Iter t = *this; ++i; return t;}
+        bool operator==(const Iter &o) const {return i == o.i;}
+    };
+    using iterator = Iter<SymbolChunks>;
+    using const_iterator = Iter<const SymbolChunks>;
+
+private:
+    std::atomic<Chunk*> &slot(const size_t c) {
+        return c < InlineChunks ? inline_[c] : overflow.load(std::memory_order_acquire)[c - InlineChunks];
+    }
+
+    void release() {
+        for (size_t c = 0; c < chunks(); ++c) delete slot(c).exchange(nullptr);
+        delete[] overflow.exchange(nullptr);
+        allocated.store(0);
+        n.store(0);
+    }
+
+    std::array<std::atomic<Chunk*>, InlineChunks> inline_{};
+    std::atomic<std::atomic<Chunk*>*> overflow{nullptr};
+    std::atomic<size_t> allocated{0};
+    std::atomic<size_t> n{0};
+};
+
 template<typename T>
 struct PerSymbol : virtual IPerSymbol {
     typedef T Type;
 
     explicit PerSymbol(const T &defInstance = T())
-        : def(defInstance) {vals.resize(SYMBOLS.size(), defInstance);}
+        : def(defInstance) {
+        vals.resize(Universe().Slots(), defInstance);
+    }
 
 //! decltype(auto) is required here for compatability with std::vector<bool> proxy references.
-    decltype(auto) operator[](size_t i) { return vals[i]; }
+//? Mutable access marks the symbol dirty for incremental checkpoints, reads through a const PerSymbol do not.
+    decltype(auto) operator[](size_t i) { vals.dirty(i) = 1; return vals[i]; }
     decltype(auto) operator[](size_t i) const { return vals[i]; }
 
-    typename std::vector<T>::iterator begin() {return vals.begin();}
-    typename std::vector<T>::iterator end() {return vals.end();}
+    typename SymbolChunks<T>::iterator begin() {MarkAll(); return {&vals, 0};}
+    typename SymbolChunks<T>::iterator end() {return {&vals, vals.size()};}
+    typename SymbolChunks<T>::const_iterator begin() const {return {&vals, 0};}
+    typename SymbolChunks<T>::const_iterator end() const {return {&vals, vals.size()};}
 
     [[nodiscard]] size_t size() const override { return vals.size(); }
     [[nodiscard]] size_t size(int sym) const override {
@@ -50,8 +178,21 @@ struct PerSymbol : virtual IPerSymbol {
         return 1;
     }
 
-    void ResetSym(int sym) override {vals[sym] = def;}
-    void ResetAll() override {std::fill(vals.begin(), vals.end(), def);}
+    void ResetSym(int sym) override {vals[sym] = def; vals.dirty(sym) = 1;}
+    void ResetAll() override {
+        vals.forEachChunk([this](auto &c, size_t, const size_t n) {
+            std::fill_n(c.vals.begin(), n, def);
+            std::fill_n(c.dirty.begin(), n, 1);
+        });
+    }
+
+    //& New slots start at the default and are marked dirty, existing slots are untouched.
+    void Grow(const size_t n) override {
+        const size_t old = vals.size();
+        if (n <= old) return;
+        vals.resize(n, def);
+        for (size_t s = old; s < n; ++s) {vals[s] = def; vals.dirty(s) = 1;}
+    }
 
     void Set(const std::string &val) override {
         if constexpr (parseable<T>::value) {
@@ -69,35 +210,145 @@ struct PerSymbol : virtual IPerSymbol {
         out << RES << std::endl;
     }
 
+    [[nodiscard]] std::string DefString() const override {
+        if constexpr (parseable<T>::value) {
+            std::ostringstream s;
+            s << std::setprecision(17) << def;
+            return s.str();
+        }
+        return "";
+    }
+
     void SetDef(const T& defInstance) {def = defInstance; ResetAll();}
     T& GetDef() {return def;}
 
 private:
-    std::vector<T> vals;
+    void MarkAll() {vals.forEachChunk([](auto &c, size_t, const size_t n) {std::fill_n(c.dirty.begin(), n, 1);});}
+
+    SymbolChunks<T> vals;
     T def;
 
 public:
-    void Save(BinWriter &w) const {
+    [[nodiscard]] size_t TypeSize() const override {return sizeof(T);}
+
+    [[nodiscard]] double Sum() const override {
+        if constexpr (std::is_arithmetic_v<T>) {
+            double s = 0;
+            for (const auto &v : *this) s += static_cast<double>(v);
+            return s;
+        }
+        return 0;
+    }
+
+//? Trivially copyable payloads (and packed bools) are written and read in one bulk copy per chunk.
+//? The stream is the same as for contiguous storage.
+    void Save(BinWriter &w) const override {
         w.val<uint32_t>(static_cast<uint32_t>(vals.size()));
         w.writeValue(def);
-        for (const T& v : vals) {
-            w.writeValue(v);
+        if constexpr (is_bool<T>) {
+            std::vector<bool> flat(begin(), end());
+            w.bits(flat);
+        } else if constexpr (std::is_trivially_copyable_v<T>) {
+            vals.forEachChunk([&w](const auto &c, size_t, const size_t n) {w.bytes(c.vals.data(), n * sizeof(T));});
+        } else {
+            for (const auto &v : *this) {
+                w.writeValue(v);
+            }
         }
     }
 
-    void Load(BinReader &r) {
+    void Load(BinReader &r) override {
         uint32_t count;
         r.val(count);
         r.readValue(def);
         vals.resize(count, def);
-        for (auto&& v : vals) {
-            if constexpr (is_bool<T> || is_bool_std_vector<T>) {
-                T tmp;
-                r.readValue(tmp);
-                v = tmp;
+        if constexpr (is_bool<T>) {
+            if (r.Legacy) { // Headerless files stored one byte per bool
+                for (uint32_t s = 0; s < count; ++s) {
+                    bool b = false;
+                    r.val(b);
+                    vals[s] = b;
+                }
+            } else {
+                std::vector<bool> flat;
+                r.bits(flat, count);
+                for (uint32_t s = 0; s < count; ++s) vals[s] = flat[s];
+            }
+        } else if constexpr (std::is_trivially_copyable_v<T>) {
+            vals.forEachChunk([&r](auto &c, size_t, const size_t n) {r.bytes(c.vals.data(), n * sizeof(T));});
+        } else {
+            for (uint32_t s = 0; s < count; ++s) {
+                vals[s] = def;
+                r.readValue(vals[s]);
+            }
+        }
+        ClearDirty();
+    }
+
+//& Incremental checkpoints, writes only the symbols touched since the last ClearDirty().
+    void SaveDirty(BinWriter &w) const override {
+        w.val<uint32_t>(static_cast<uint32_t>(DirtyCount()));
+        for (uint32_t s = 0; s < vals.size(); ++s) {
+            if (!vals.dirty(s)) continue;
+            w.val(s);
+            if constexpr (is_bool<T>) w.val<bool>(vals[s]);
+            else w.writeValue(vals[s]);
+        }
+    }
+
+    void LoadDirty(BinReader &r) override {
+        uint32_t count = 0;
+        r.val(count);
+        for (uint32_t i = 0; i < count && r.ok(); ++i) {
+            uint32_t s;
+            r.val(s);
+            if (s >= vals.size()) throw std::runtime_error("PerSymbol: journal symbol out of range for " + nm);
+            if constexpr (is_bool<T>) {
+                bool tmp;
+                r.val(tmp);
+                vals[s] = tmp;
             } else {
-                r.readValue(v);
+                r.readValue(vals[s]);
             }
         }
     }
-};
\ No newline at end of file
+
+    void ClearDirty() override {vals.forEachChunk([](auto &c, size_t, const size_t n) {std::fill_n(c.dirty.begin(), n, 0);});}
+    [[nodiscard]] size_t DirtyCount() const override {
+        size_t count = 0;
+        vals.forEachChunk([&count](const auto &c, size_t, const size_t n) {
+            count += static_cast<size_t>(std::count(c.dirty.begin(), c.dirty.begin() + n, 1));
+        });
+        return count;
+    }
+};
+
+//? Per-symbol flags written by background threads (e.g. AddSymbol's warm) while readers poll them. Every slot
+//? is its own atomic byte, unlike PerSymbol<bool> whose bits share words, so writes never race with a
+//? neighbour's. Storage for the whole universe is allocated up front, Grow only moves the logical size.
+struct AtomicFlags final : virtual IPerSymbol {
+    AtomicFlags() : flags(new std::atomic<uint8_t>[SymbolUniverse::MaxSlots]()) {n = Universe().Slots();}
+
+    std::atomic<uint8_t> &operator[](const size_t sym) {return flags[sym];}
+    const std::atomic<uint8_t> &operator[](const size_t sym) const {return flags[sym];}
+
+    [[nodiscard]] size_t size() const override {return n;}
+    [[nodiscard]] size_t size(int) const override {return 1;}
+    void Set(const std::string &) override {}
+    void ResetSym(const int sym) override {flags[sym].store(0, std::memory_order_release);}
+    void ResetAll() override {for (size_t s = 0; s < n; ++s) flags[s].store(0, std::memory_order_release);}
+    void PrintDef() override {}
+    void Grow(const size_t slots) override {n = std::max(n, slots);}
+
+private:
+    std::unique_ptr<std::atomic<uint8_t>[]> flags;
+    size_t n = 0;
+};
+
+//? Schema of a list of members, changes whenever a member is added, removed, renamed or resized.
+inline uint64_t SchemaHash(const std::vector<IPerSymbol*> &list) {
+    Fnv1a h;
+    for (const IPerSymbol* p : list)
+        h.str(p->Name()).val(static_cast<uint64_t>(p->TypeSize()));
+    return h.h;
+}
\ No newline at end of file
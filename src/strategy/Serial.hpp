@@ -1,5 +1,13 @@
 #pragma once
 
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <BOT.hpp>
 
 template<typename T>
@@ -8,18 +16,174 @@ struct is_std_vector : std::false_type{};
 template<typename T, typename A>
 struct is_std_vector<std::vector<T,A>> : std::true_type{};
 
+template<typename T>
+struct is_bulk_vector : std::false_type{};
+
+template<typename T, typename A> requires (std::is_trivially_copyable_v<T> && !std::is_same_v<T, bool>)
+struct is_bulk_vector<std::vector<T,A>> : std::true_type{};
+
+//? 64-bit FNV-1a, used for schema hashes and content addressed keys.
+struct Fnv1a {
+    uint64_t h = 0xcbf29ce484222325ull;
+
+    Fnv1a &bytes(const void* p, const size_t n) {
+        const auto* b = static_cast<const uint8_t*>(p);
+        for (size_t i = 0; i < n; ++i) {
+            h ^= b[i];
+            h *= 0x100000001b3ull;
+        }
+        return *this;
+    }
+
+    Fnv1a &str(const std::string &s) {
+        const auto n = static_cast<uint64_t>(s.size());
+        bytes(&n, sizeof(n));
+        return bytes(s.data(), s.size());
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    Fnv1a &val(const T &v) {return bytes(&v, sizeof(T));}
+};
+
+//? Word-at-a-time payload checksum. Independent of how the stream is chunked into updates.
+struct Checksum64 {
+    uint64_t h = 0x9e3779b97f4a7c15ull;
+
+    void update(const void* p, size_t n) {
+        const auto* b = static_cast<const uint8_t*>(p);
+        while (n > 0 && fill != 0) {
+            carry |= static_cast<uint64_t>(*b++) << (8 * fill);
+            --n;
+            if (++fill == 8) {mix(carry); carry = 0; fill = 0;}
+        }
+        for (; n >= 8; n -= 8, b += 8) {
+            uint64_t w;
+            std::memcpy(&w, b, 8);
+            mix(w);
+        }
+        for (; n > 0; --n) carry |= static_cast<uint64_t>(*b++) << (8 * fill++);
+    }
+
+    [[nodiscard]] uint64_t digest() const {
+        uint64_t d = h;
+        if (fill) d = (std::rotl(d ^ carry, 31) * 0x9fb21c651e98df25ull) ^ fill;
+        return d ^ (d >> 29);
+    }
+
+private:
+    void mix(const uint64_t w) {h = std::rotl(h ^ (w * 0xbf58476d1ce4e5b9ull), 27) * 0x94d049bb133111ebull;}
+    uint64_t carry = 0;
+    int fill = 0;
+};
+
+struct SerialHeader {
+    static constexpr uint32_t Magic = 0x54414249; // "IBAT"
+    static constexpr uint16_t Version = 2;
+
+    uint32_t magic = Magic;
+    uint16_t version = Version;
+    uint16_t flags = 0;
+    uint64_t schema = 0;
+    uint64_t length = 0;
+    uint64_t checksum = 0;
+};
+
+//& Unique sibling of path for write-then-rename, pid plus a random suffix so threads and processes never collide.
+inline std::string TempPath(const std::string &path) {
+#ifdef _WIN32
+    const long pid = _getpid();
+#else
+    const long pid = getpid();
+#endif
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), ".tmp%ld.%016llx", pid, static_cast<unsigned long long>(rng()));
+    return path + suffix;
+}
+
+//& Flushes tmp to stable storage and renames it over path, so readers and crashes see the old or the new file.
+//& On POSIX the directory is synced too, so the rename is durable before the caller drops what it replaces.
+//& Removes tmp and returns false when either step fails.
+inline bool CommitFile(const std::string &tmp, const std::string &path) {
+    bool synced = false;
+#ifdef _WIN32
+    if (const int fd = _open(tmp.c_str(), _O_RDWR); fd >= 0) {synced = _commit(fd) == 0; _close(fd);}
+#else
+    if (const int fd = ::open(tmp.c_str(), O_RDWR); fd >= 0) {synced = ::fsync(fd) == 0; ::close(fd);}
+#endif
+    std::error_code ec;
+    if (synced) std::filesystem::rename(tmp, path, ec);
+    if (!synced || ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+#ifndef _WIN32
+    const std::string dir = std::filesystem::path(path).parent_path().string();
+    if (const int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY); fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#endif
+    return true;
+}
+
+struct BinWriter;
+struct BinReader;
+
+template<typename T>
+concept self_serial = requires(const T &c, T &m, BinWriter &w, BinReader &r) {
+    c.Save(w);
+    m.Load(r);
+};
+
+//? IB Bar, kept in per-symbol state by lazy gating. Serialized field by field since its time is a string.
+template<typename T>
+concept bar_record = requires(const T &b) {b.time; b.high; b.low; b.open; b.close; b.wap; b.volume; b.count;};
+
+//? Buffered binary writer. Scalars and trivially copyable vectors are memcpy'd into a large buffer that is
+//? flushed in one write when full. The file starts with a SerialHeader (schema hash, payload length, checksum)
+//? that is patched on Close(). A default constructed writer accumulates in memory only.
+//? A file writer that could not be opened, or is written after Close(), is failed rather than buffering.
 struct BinWriter {
-    std::ofstream out;
-    explicit BinWriter(const std::string& path)
-        : out(path, std::ios::binary) {}
+    static constexpr size_t BufferSize = 1 << 22;
+
+    BinWriter() : memory(true) {}
+
+    explicit BinWriter(const std::string& path, const uint64_t schema = 0)
+        : out(path, std::ios::binary) {
+        if (!out) {failed = true; return;}
+        header.schema = schema;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        buf.reserve(BufferSize);
+    }
+
+    ~BinWriter() {Close();}
+
+    BinWriter(const BinWriter&) = delete;
+    BinWriter &operator=(const BinWriter&) = delete;
 
     template<typename T>
     void val(const T& v) {
-        out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+        static_assert(std::is_trivially_copyable_v<T>, "BinWriter::val requires a trivially copyable type");
+        bytes(&v, sizeof(T));
     }
 
     void bytes(const void* p, const size_t n) {
-        out.write(static_cast<const char*>(p), n);
+        if (memory) {
+            const auto* b = static_cast<const char*>(p);
+            buf.insert(buf.end(), b, b + n);
+            return;
+        }
+        if (!out.is_open()) {failed = true; return;}
+        if (buf.size() + n > BufferSize) flush();
+        if (n >= BufferSize) {
+            sum.update(p, n);
+            header.length += n;
+            out.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+            return;
+        }
+        const auto* b = static_cast<const char*>(p);
+        buf.insert(buf.end(), b, b + n);
     }
 
     void str(const std::string& s) {
@@ -28,49 +192,210 @@ struct BinWriter {
         bytes(s.data(), len);
     }
 
+    //& Packs a bool vector to bits instead of the proxy-per-element path.
+    void bits(const std::vector<bool> &v) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            word |= static_cast<uint64_t>(v[i]) << (i & 63);
+            if ((i & 63) == 63) {val(word); word = 0;}
+        }
+        if (v.size() & 63) val(word);
+    }
+
     template<typename T>
     void writeValue(const T& v) {
-        if constexpr (is_std_vector<T>::value) {
+        if constexpr (std::is_same_v<T, std::vector<bool>>) {
+            val(static_cast<uint32_t>(v.size()));
+            bits(v);
+        } else if constexpr (is_bulk_vector<T>::value) {
             const auto n = static_cast<uint32_t>(v.size());
             val(n);
             bytes(v.data(), n * sizeof(typename T::value_type));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            val(static_cast<uint32_t>(v.size()));
+            bytes(v.data(), v.size());
+        } else if constexpr (bar_record<T>) {
+            str(v.time);
+            val(v.high); val(v.low); val(v.open); val(v.close);
+            val(v.wap); val(v.volume); val(v.count);
+        } else if constexpr (self_serial<T>) {
+            v.Save(*this);
+        } else if constexpr (requires {v.begin(); v.size(); typename T::value_type;}) {
+            val(static_cast<uint32_t>(v.size()));
+            for (const auto &e : v) writeValue(e);
+        } else if constexpr (requires {v.first; v.second;}) {
+            writeValue(v.first);
+            writeValue(v.second);
         } else {
             val(v);
         }
     }
+
+    //& Flushes the buffer and finalizes the header, subsequent writes fail the writer.
+    void Close() {
+        if (memory || !out.is_open()) return;
+        flush();
+        header.checksum = sum.digest();
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        if (!out) failed = true;
+    }
+
+    //& Contents of an in-memory writer.
+    [[nodiscard]] const std::vector<char> &Buffer() const {return buf;}
+    //& Empties an in-memory writer, keeping its capacity for reuse.
+    void Clear() {if (memory) buf.clear();}
+    //& False once opening, any write or Close() failed. Still valid after Close().
+    [[nodiscard]] bool ok() const {return !failed && (!out.is_open() || out.good());}
+
+private:
+    void flush() {
+        if (buf.empty()) return;
+        sum.update(buf.data(), buf.size());
+        header.length += buf.size();
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        buf.clear();
+    }
+
+    std::ofstream out;
+    std::vector<char> buf;
+    SerialHeader header{};
+    Checksum64 sum{};
+    bool memory = false;
+    bool failed = false;
 };
 
+//? Reads and verifies the whole payload in a single read, then deserializes from memory.
+//? Files without a SerialHeader are read as legacy unversioned payloads, unless a schema is requested: a
+//? headerless file cannot prove it matches one, so it is rejected then unless allowLegacy is set.
 struct BinReader {
-    std::ifstream in;
-    explicit BinReader(const std::string& path)
-        : in(path, std::ios::binary) {}
+    explicit BinReader(const std::string& path, const uint64_t schema = 0, const bool allowLegacy = false) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {failed = true; return;}
+        const auto size = static_cast<size_t>(in.tellg());
+        in.seekg(0);
+
+        SerialHeader h{};
+        if (size >= sizeof(h)) in.read(reinterpret_cast<char*>(&h), sizeof(h));
+
+        if (size < sizeof(h) || h.magic != SerialHeader::Magic) {
+            if (schema != 0 && !allowLegacy)
+                throw std::runtime_error("BinReader: " + path + " has no header, cannot check its schema");
+            in.seekg(0);
+            buf.resize(size);
+            in.read(buf.data(), static_cast<std::streamsize>(size));
+            Legacy = true;
+            return;
+        }
+
+        if (h.version > SerialHeader::Version)
+            throw std::runtime_error("BinReader: " + path + " has unsupported version " + std::to_string(h.version));
+        if (schema != 0 && h.schema != schema)
+            throw std::runtime_error("BinReader: " + path + " schema mismatch");
+        if (h.length != size - sizeof(h))
+            throw std::runtime_error("BinReader: " + path + " truncated");
+
+        buf.resize(h.length);
+        in.read(buf.data(), static_cast<std::streamsize>(h.length));
+
+        Checksum64 sum;
+        sum.update(buf.data(), buf.size());
+        if (sum.digest() != h.checksum)
+            throw std::runtime_error("BinReader: " + path + " checksum mismatch");
+
+        Header = h;
+    }
+
+    explicit BinReader(std::vector<char> data) : buf(std::move(data)) {}
+
+    SerialHeader Header{};
+    bool Legacy = false;
 
     template<typename T>
     void val(T& v) {
-        in.read(reinterpret_cast<char*>(&v), sizeof(T));
+        static_assert(std::is_trivially_copyable_v<T>, "BinReader::val requires a trivially copyable type");
+        bytes(&v, sizeof(T));
     }
 
     void bytes(void* p, const size_t n) {
-        in.read(static_cast<char*>(p), n);
+        if (pos + n > buf.size()) {
+            failed = true;
+            std::memset(p, 0, n);
+            pos = buf.size();
+            return;
+        }
+        std::memcpy(p, buf.data() + pos, n);
+        pos += n;
     }
 
     std::string str() {
         uint16_t len;
         val(len);
         std::string s(len, '\0');
-        in.read(s.data(), len);
+        bytes(s.data(), len);
         return s;
     }
 
+    void bits(std::vector<bool> &v, const size_t n) {
+        v.assign(n, false);
+        uint64_t word = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if ((i & 63) == 0) val(word);
+            v[i] = (word >> (i & 63)) & 1;
+        }
+    }
+
     template<typename T>
     void readValue(T& v) {
-        if constexpr (is_std_vector<T>::value) {
+        if constexpr (std::is_same_v<T, std::vector<bool>>) {
+            uint32_t n;
+            val(n);
+            bits(v, n);
+        } else if constexpr (is_bulk_vector<T>::value) {
             uint32_t n;
             val(n);
+            if (!fits(n * sizeof(typename T::value_type))) return;
             v.resize(n);
             bytes(v.data(), n * sizeof(typename T::value_type));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            uint32_t n;
+            val(n);
+            if (!fits(n)) return;
+            v.resize(n);
+            bytes(v.data(), n);
+        } else if constexpr (bar_record<T>) {
+            v.time = str();
+            val(v.high); val(v.low); val(v.open); val(v.close);
+            val(v.wap); val(v.volume); val(v.count);
+        } else if constexpr (self_serial<T>) {
+            v.Load(*this);
+        } else if constexpr (requires {v.clear(); v.emplace_back(); v.back();}) {
+            uint32_t n;
+            val(n);
+            v.clear();
+            for (uint32_t i = 0; i < n && !failed; ++i) readValue(v.emplace_back());
+        } else if constexpr (requires {v.first; v.second;}) {
+            readValue(v.first);
+            readValue(v.second);
         } else {
             val(v);
         }
     }
+
+    [[nodiscard]] bool ok() const {return !failed;}
+    [[nodiscard]] bool eof() const {return pos >= buf.size();}
+    explicit operator bool() const {return ok();}
+
+private:
+    bool fits(const size_t n) {
+        if (pos + n <= buf.size()) return true;
+        failed = true;
+        pos = buf.size();
+        return false;
+    }
+
+    std::vector<char> buf;
+    size_t pos = 0;
+    bool failed = false;
 };
\ No newline at end of file
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <Decimal.h>
+#include <PerSymbol.hpp>
+
+enum class SeriesOp : uint8_t {
+    Open, High, Low, Close, Volume,
+    PrevClose, Range, TrueRange, TypicalPrice, PriceVolume,
+    RollingSum, RollingMax, RollingMin, EMA, Wilder, SessionSum, Ratio,
+    Diff, SessionMax, SessionMin, PrevSession, SessionRollingMin
+};
+
+//? Shared per-bar intermediate series. Indicators and filters declare what they read in declare(), equal
+//? declarations collapse into one node (common subexpression elimination), and Compile() keeps only nodes
+//? reachable from a Require()d output. Inputs always have lower ids, so id order is a topological order.
+//? Per-symbol state is one flat array per symbol (values, aux, counts, then windows), stepped once per bar
+//? before the indicators, which read their outputs with Value().
+class SeriesGraph {
+public:
+    using Node = int;
+
+    struct Def {
+        SeriesOp op;
+        Node a = -1, b = -1;
+        int n = 0;
+        bool operator==(const Def&) const = default;
+    };
+
+    //& Bar fields
+    Node Open() {return add({SeriesOp::Open});}
+    Node High() {return add({SeriesOp::High});}
+    Node Low() {return add({SeriesOp::Low});}
+    Node Close() {return add({SeriesOp::Close});}
+    Node Volume() {return add({SeriesOp::Volume});}
+
+    //& Derived series
+    Node PrevClose() {return add({SeriesOp::PrevClose, Close()});}
+    Node Range() {return add({SeriesOp::Range, High(), Low()});}
+    Node TrueRange() {return add({SeriesOp::TrueRange, PrevClose()});}
+    Node TypicalPrice() {return add({SeriesOp::TypicalPrice, High(), Low()});}
+    Node PriceVolume() {return add({SeriesOp::PriceVolume, TypicalPrice(), Volume()});}
+
+    Node RollingSum(const Node in, const int n) {return add({SeriesOp::RollingSum, in, -1, n});}
+    Node RollingMax(const Node in, const int n) {return add({SeriesOp::RollingMax, in, -1, n});}
+    Node RollingMin(const Node in, const int n) {return add({SeriesOp::RollingMin, in, -1, n});}
+    Node EMA(const Node in, const int n) {return add({SeriesOp::EMA, in, -1, n});}
+    //? Wilder smoothing, seeded with the simple mean of the first n values.
+    Node Wilder(const Node in, const int n) {return add({SeriesOp::Wilder, in, -1, n});}
+    //? Running sum reset at each new day.
+    Node SessionSum(const Node in) {return add({SeriesOp::SessionSum, in});}
+    Node Ratio(const Node num, const Node den) {return add({SeriesOp::Ratio, num, den});}
+    Node Diff(const Node a, const Node b) {return add({SeriesOp::Diff, a, b});}
+    //? Running max/min reset at each new day.
+    Node SessionMax(const Node in) {return add({SeriesOp::SessionMax, in});}
+    Node SessionMin(const Node in) {return add({SeriesOp::SessionMin, in});}
+    //? Value in had on the last bar of the previous session, Count() is the sessions completed.
+    Node PrevSession(const Node in) {return add({SeriesOp::PrevSession, in});}
+    //? Minimum of the final values of in over the last n completed sessions.
+    Node SessionRollingMin(const Node in, const int n) {return add({SeriesOp::SessionRollingMin, in, -1, n});}
+
+    //& Marks a node as read by an indicator or filter, everything it depends on stays live.
+    Node Require(const Node node) {
+        ++declared;
+        roots.push_back(node);
+        compiled = false;
+        return node;
+    }
+
+    //& Prunes unreachable nodes and lays out per-symbol state. Call once after every declare().
+    void Compile() {
+        std::vector<uint8_t> live(defs.size(), 0);
+        for (const Node r : roots) live[r] = 1;
+        for (Node i = static_cast<Node>(defs.size()) - 1; i >= 0; --i) {
+            if (!live[i]) continue;
+            if (defs[i].a >= 0) live[defs[i].a] = 1;
+            if (defs[i].b >= 0) live[defs[i].b] = 1;
+        }
+        order.clear();
+        ringOffset.assign(defs.size(), 0);
+        ringSize = 0;
+        for (Node i = 0; i < static_cast<Node>(defs.size()); ++i) {
+            if (!live[i]) continue;
+            order.push_back(i);
+            if (windowed(defs[i].op)) {
+                ringOffset[i] = ringSize;
+                ringSize += static_cast<size_t>(std::max(1, defs[i].n));
+            }
+        }
+        Row def(defs.size(), ringSize);
+        for (const Node i : order)
+            if (defs[i].op == SeriesOp::PrevSession || defs[i].op == SeriesOp::SessionRollingMin)
+                def.aux(i) = std::numeric_limits<double>::quiet_NaN(); // No session seen yet
+        state.SetDef(std::move(def));
+        compiled = true;
+    }
+
+    //& Evaluates every live node for sym in topological order.
+    void Step(const Bar &b, const int sym, const bool newDay = false) {
+        if (!compiled) throw std::runtime_error("SeriesGraph: Step before Compile");
+        Row &r = state[sym];
+        double* v = r.v();
+        for (const Node i : order) {
+            const Def &d = defs[i];
+            double &aux = r.aux(i);
+            double &cnt = r.count(i);
+            switch (d.op) {
+                case SeriesOp::Open: v[i] = b.open; break;
+                case SeriesOp::High: v[i] = b.high; break;
+                case SeriesOp::Low: v[i] = b.low; break;
+                case SeriesOp::Close: v[i] = b.close; break;
+                case SeriesOp::Volume: v[i] = DecimalFunctions::decimalToDouble(b.volume); break;
+                case SeriesOp::PrevClose:
+                    v[i] = cnt++ ? aux : v[d.a];
+                    aux = v[d.a];
+                    break;
+                case SeriesOp::Range: v[i] = v[d.a] - v[d.b]; break;
+                case SeriesOp::TrueRange: v[i] = std::max(b.high, v[d.a]) - std::min(b.low, v[d.a]); break;
+                case SeriesOp::TypicalPrice: v[i] = (v[d.a] + v[d.b] + b.close) / 3.0; break;
+                case SeriesOp::PriceVolume: v[i] = v[d.a] * v[d.b]; break;
+                case SeriesOp::RollingSum: {
+                    double &slot = r.ring(ringOffset[i])[static_cast<uint64_t>(cnt) % d.n];
+                    aux += v[d.a] - slot;
+                    slot = v[d.a];
+                    ++cnt;
+                    v[i] = aux;
+                    break;
+                }
+                case SeriesOp::RollingMax:
+                case SeriesOp::RollingMin: {
+                    double* ring = r.ring(ringOffset[i]);
+                    ring[static_cast<uint64_t>(cnt) % d.n] = v[d.a];
+                    ++cnt;
+                    const auto filled = static_cast<ptrdiff_t>(std::min<double>(cnt, d.n));
+                    v[i] = d.op == SeriesOp::RollingMax ? *std::max_element(ring, ring + filled)
+                                                        : *std::min_element(ring, ring + filled);
+                    break;
+                }
+                case SeriesOp::EMA:
+                    v[i] = cnt++ ? v[i] + 2.0 / (d.n + 1.0) * (v[d.a] - v[i]) : v[d.a];
+                    break;
+                case SeriesOp::Wilder:
+                    if (cnt < d.n) {
+                        aux += v[d.a];
+                        v[i] = aux / ++cnt;
+                    } else {
+                        v[i] += (v[d.a] - v[i]) / d.n;
+                    }
+                    break;
+                case SeriesOp::SessionSum:
+                    if (newDay) aux = 0;
+                    aux += v[d.a];
+                    v[i] = aux;
+                    break;
+                case SeriesOp::Ratio: v[i] = v[d.b] != 0 ? v[d.a] / v[d.b] : 0; break;
+                case SeriesOp::Diff: v[i] = v[d.a] - v[d.b]; break;
+                case SeriesOp::SessionMax:
+                    v[i] = newDay || !cnt++ ? v[d.a] : std::max(v[i], v[d.a]);
+                    break;
+                case SeriesOp::SessionMin:
+                    v[i] = newDay || !cnt++ ? v[d.a] : std::min(v[i], v[d.a]);
+                    break;
+                case SeriesOp::PrevSession:
+                    if (newDay && !std::isnan(aux)) {v[i] = aux; ++cnt;}
+                    aux = v[d.a];
+                    break;
+                case SeriesOp::SessionRollingMin:
+                    if (newDay && !std::isnan(aux)) {
+                        double* ring = r.ring(ringOffset[i]);
+                        ring[static_cast<uint64_t>(cnt) % d.n] = aux;
+                        ++cnt;
+                        v[i] = *std::min_element(ring, ring + static_cast<ptrdiff_t>(std::min<double>(cnt, d.n)));
+                    }
+                    aux = v[d.a];
+                    break;
+            }
+        }
+    }
+
+    //& Rebuilds sym from history, a new day starts whenever the date part of the bar time changes.
+    void WarmUp(const std::vector<Bar> &data, const int sym) {
+        ResetSym(sym);
+        for (size_t k = 0; k < data.size(); ++k)
+            Step(data[k], sym, k > 0 && NewDay(data[k - 1], data[k]));
+    }
+    [[nodiscard]] static bool NewDay(const Bar &prev, const Bar &b) {
+        return prev.time.compare(0, 8, b.time, 0, 8) != 0;
+    }
+
+    [[nodiscard]] double Value(const Node node, const int sym) const {return std::as_const(state)[sym].v()[node];}
+    //& Bars (sessions for session windows) seen by a stateful node, e.g. to tell when a window is full.
+    [[nodiscard]] uint32_t Count(const Node node, const int sym) const {
+        return static_cast<uint32_t>(std::as_const(state)[sym].count(node));
+    }
+
+    //& Hash of the live node layout, part of the snapshot schema of whoever saves this graph.
+    [[nodiscard]] uint64_t Schema() const {
+        Fnv1a h;
+        for (const Node i : order) h.val(defs[i].op).val(defs[i].a).val(defs[i].b).val(defs[i].n);
+        return h.val(ringSize).h;
+    }
+
+    void Grow(const size_t slots) {state.Grow(slots);}
+    void ResetSym(const int sym) {state.ResetSym(sym);}
+    void ResetAll() {state.ResetAll();}
+    void Members(std::vector<IPerSymbol*> &out) {out.push_back(&state);}
+    void Save(BinWriter &w) const {state.Save(w);}
+    void Load(BinReader &r) {state.Load(r);}
+
+    //& Required outputs, unique nodes after CSE, and nodes evaluated per bar after pruning.
+    [[nodiscard]] size_t Declared() const {return declared;}
+    [[nodiscard]] size_t Nodes() const {return defs.size();}
+    [[nodiscard]] size_t Live() const {return order.size();}
+
+    void Print() const {
+        auto out = ibat::sout;
+        out << PURPLE << "Series graph: " << RES << declared << " required outputs, " << defs.size() << " unique nodes, "
+            << order.size() << " live" << std::endl;
+    }
+
+private:
+    //? [values | aux | counts | windows], counts are kept as doubles so the row stays one allocation.
+    struct Row {
+        Row() = default;
+        Row(const size_t nodes, const size_t ring) : nodes(nodes), cells(3 * nodes + ring, 0) {}
+
+        size_t nodes = 0;
+        std::vector<double> cells;
+
+        double* v() {return cells.data();}
+        [[nodiscard]] const double* v() const {return cells.data();}
+        double &aux(const Node i) {return cells[nodes + i];}
+        double &count(const Node i) {return cells[2 * nodes + i];}
+        [[nodiscard]] double count(const Node i) const {return cells[2 * nodes + i];}
+        double* ring(const size_t offset) {return cells.data() + 3 * nodes + offset;}
+
+        void Save(BinWriter &w) const {w.val(static_cast<uint64_t>(nodes)); w.writeValue(cells);}
+        void Load(BinReader &r) {
+            uint64_t n = 0;
+            r.val(n);
+            nodes = n;
+            r.readValue(cells);
+        }
+    };
+
+    static bool windowed(const SeriesOp op) {
+        return op == SeriesOp::RollingSum || op == SeriesOp::RollingMax || op == SeriesOp::RollingMin
+            || op == SeriesOp::SessionRollingMin;
+    }
+
+    Node add(Def d) {
+        if (windowed(d.op) || d.op == SeriesOp::EMA || d.op == SeriesOp::Wilder) {
+            if (d.n <= 0) throw std::runtime_error("SeriesGraph: window length must be positive");
+        }
+        for (Node i = 0; i < static_cast<Node>(defs.size()); ++i)
+            if (defs[i] == d) return i;
+        compiled = false;
+        defs.push_back(d);
+        return static_cast<Node>(defs.size()) - 1;
+    }
+
+    std::vector<Def> defs;
+    std::vector<Node> roots;
+    std::vector<Node> order;
+    std::vector<size_t> ringOffset;
+    size_t ringSize = 0;
+    size_t declared = 0;
+    bool compiled = false;
+    PerSymbol<Row> state;
+};
\ No newline at end of file
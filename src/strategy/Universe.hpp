@@ -0,0 +1,119 @@
+#pragma once
+
+#include <BOT.hpp>
+
+enum class SlotState : uint8_t {Free, Warming, Active};
+
+//? Runtime symbol universe. Symbols map to dense slots that PerSymbol members index; removed slots are
+//? reused by later additions. Seed() sets the startup universe so slot == index into the symbol list; it must
+//? run after symbols load and before members are built, and again whenever SYMBOLS is reloaded.
+//? Slot state is readable lock free from reader threads, structural changes take the lock.
+class SymbolUniverse {
+public:
+    static constexpr size_t MaxSlots = 1 << 18;
+
+    SymbolUniverse() : states(new std::atomic<uint8_t>[MaxSlots]()) {}
+
+    //& Replaces the universe with symbols, all Active. Runtime additions are dropped.
+    void Seed(const std::vector<std::string> &symbols) {
+        {
+            std::lock_guard lock(mtx);
+            for (size_t s = 0; s < names.size(); ++s) states[s].store(static_cast<uint8_t>(SlotState::Free));
+            names.clear();
+            index.clear();
+            freeSlots.clear();
+            slots.store(0, std::memory_order_release);
+        }
+        for (const auto &s : symbols) Activate(Add(s));
+        seeded.store(true, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool Seeded() const {return seeded.load(std::memory_order_acquire);}
+
+    //& Slot for name, reusing a freed slot when there is one. New slots start Warming.
+    int Add(const std::string &name) {return Insert(name).first;}
+
+    //& Same as Add, second is false when name already had a slot (Warming or Active) and nothing changed.
+    std::pair<int, bool> Insert(const std::string &name) {
+        std::lock_guard lock(mtx);
+        if (const auto it = index.find(name); it != index.end()) return {it->second, false};
+
+        int slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            names[slot] = name;
+        } else {
+            if (names.size() >= MaxSlots) throw std::runtime_error("SymbolUniverse: slot limit reached adding " + name);
+            slot = static_cast<int>(names.size());
+            names.push_back(name);
+        }
+        index.emplace(name, slot);
+        states[slot].store(static_cast<uint8_t>(SlotState::Warming), std::memory_order_release);
+        slots.store(names.size(), std::memory_order_release);
+        return {slot, true};
+    }
+
+    //& Warming -> Active, false when the slot was removed (or re-added) in the meantime.
+    bool Activate(const int slot) {
+        auto expected = static_cast<uint8_t>(SlotState::Warming);
+        return states[slot].compare_exchange_strong(expected, static_cast<uint8_t>(SlotState::Active),
+                                                    std::memory_order_acq_rel);
+    }
+
+    //& Deactivates the slot immediately and returns it to the free list.
+    void Remove(const int slot) {
+        std::lock_guard lock(mtx);
+        if (State(slot) == SlotState::Free) return;
+        states[slot].store(static_cast<uint8_t>(SlotState::Free), std::memory_order_release);
+        index.erase(names[slot]);
+        names[slot].clear();
+        freeSlots.push_back(slot);
+    }
+
+    [[nodiscard]] SlotState State(const int slot) const {
+        return static_cast<SlotState>(states[slot].load(std::memory_order_acquire));
+    }
+    [[nodiscard]] bool Active(const int slot) const {return State(slot) == SlotState::Active;}
+
+    //& High water mark of slots, every PerSymbol is at least this large.
+    [[nodiscard]] size_t Slots() const {return slots.load(std::memory_order_acquire);}
+
+    [[nodiscard]] int Find(const std::string &name) const {
+        std::lock_guard lock(mtx);
+        const auto it = index.find(name);
+        return it == index.end() ? -1 : it->second;
+    }
+
+    [[nodiscard]] std::string Name(const int slot) const {
+        std::lock_guard lock(mtx);
+        return names[slot];
+    }
+
+    [[nodiscard]] std::vector<int> ActiveSlots() const {
+        std::vector<int> out;
+        const auto n = static_cast<int>(Slots());
+        for (int s = 0; s < n; ++s) if (Active(s)) out.push_back(s);
+        return out;
+    }
+
+private:
+    mutable std::mutex mtx;
+    std::unique_ptr<std::atomic<uint8_t>[]> states;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> index;
+    std::vector<int> freeSlots;
+    std::atomic<size_t> slots{0};
+    std::atomic<bool> seeded{false};
+};
+
+//? Falls back to seeding from SYMBOLS on first use once it is loaded, never from an empty list.
+inline SymbolUniverse &Universe() {
+    static SymbolUniverse u;
+    if (!u.Seeded() && !SYMBOLS.empty()) {
+        static std::mutex seedMtx;
+        std::lock_guard lock(seedMtx);
+        if (!u.Seeded()) u.Seed(SYMBOLS);
+    }
+    return u;
+}
\ No newline at end of file
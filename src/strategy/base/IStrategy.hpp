@@ -4,13 +4,23 @@
 
 #include <BOT.hpp>
 #include <Calc.hpp>
+#include <AsyncLog.hpp>
 #include <PerSymbol.hpp>
 
 #include <IFilter.hpp>
+#include <FilterGate.hpp>
 #include <IIndicator.hpp>
+#include <SharedIndicator.hpp>
 
 #include <Integrators.hpp>
+#include <Collapse.hpp>
+#include <SeriesGraph.hpp>
 #include <Interfaces.hpp>
+#include <FeatureCache.hpp>
+#include <Checkpoint.hpp>
+#include <Bootstrap.hpp>
+#include <ShardedLedger.hpp>
+#include <LodSeries.hpp>
 
 #include <TensorForge.hpp>
 #include <Temporal.hpp>
@@ -36,6 +46,7 @@ public:
     int windowLength = 10;
     bool GenerateCollapsed = false;
     static constexpr size_t NumCollapsed = 4;
+    CollapseEngine<NumCollapsed> Collapser{{5, 15, 30, 60}}; // Set other factors with Collapser.SetFactors
 
     Date SyncDate = Date(0);
 
@@ -45,8 +56,11 @@ public:
     PerSymbol<int64_t> FirstTime;
     PerSymbol<Bar const*> PrevBar;
     PerSymbol<std::vector<Bar const*>> PrevBars;
-    PerSymbol<bool> Warming;
+    AtomicFlags Warming;
     PerSymbol<int64_t> StartTime;
+    //? Output of CollapseSequences, [feature][level][step] at the offsets in CollapsedOffsets.
+    PerSymbol<std::vector<float>> CollapsedSeqs;
+    PerSymbol<std::vector<size_t>> CollapsedOffsets;
 
 private:
     PerSymbol<DataStatus> TensorStatus{DataStatus::Empty};
@@ -67,6 +81,10 @@ public:
 /*  *** STRAT PUBLIC */
     void(*callback)() noexcept = []() noexcept -> void {BOT->DayEnd();};
     Portfolio* Port = nullptr;
+    //? When set, LongSignal/ShortSignal reserve exposure and Exit/consumePNL release it here instead of under enterTex.
+    ShardedLedger* Ledger = nullptr;
+    //? Registry of the StrategySet this strategy was built in, null when its shared indicators are private.
+    IndicatorRegistry* Shared = IndicatorRegistry::Current();
     std::shared_ptr<std::barrier<void(*)() noexcept>> SyncPoint = nullptr;
 
 //& Core methods
@@ -76,6 +94,102 @@ public:
     void PrintVarDefs() const;
     void Save(const std::string &file) const;
     void Load(const std::string &file) const;
+    //? Bumped whenever SaveState's layout changes outside MasterList.
+    //? 2: series graph state. 3: positions and rolling normalizer windows.
+    static constexpr uint32_t SnapshotVersion = 3;
+    [[nodiscard]] uint64_t Schema() const {
+        return Fnv1a().val(SchemaHash(MasterList)).val(SnapshotVersion).val(Series.Schema()).h;
+    }
+
+//& State snapshots
+    void SaveState(BinWriter &w) const;
+    void LoadState(BinReader &r);
+    //? Writes the full strategy state as of the given bar time, replay resumes after asOf.
+    //? Written to a temporary sibling and renamed over file, a crash leaves the previous snapshot intact.
+    void SaveSnapshot(const std::string &file, int64_t asOf) const {
+        const std::string tmp = TempPath(file);
+        {
+            BinWriter w(tmp, Schema());
+            w.val(asOf);
+            SaveState(w);
+            w.Close();
+            if (!w.ok()) {
+                std::error_code ec;
+                std::filesystem::remove(tmp, ec);
+                throw std::runtime_error("IStrategy: cannot write snapshot " + file);
+            }
+        }
+        if (!CommitFile(tmp, file)) throw std::runtime_error("IStrategy: cannot publish snapshot " + file);
+    }
+    //? Restores a snapshot and returns its asOf time, to be passed to WarmUp as startTime.
+    int64_t LoadSnapshot(const std::string &file) {
+        BinReader r(file, Schema());
+        int64_t asOf = 0;
+        r.val(asOf);
+        LoadState(r);
+        if (!r.ok()) throw std::runtime_error("IStrategy: snapshot " + file + " is incomplete");
+        return asOf;
+    }
+    //? Digest of the serialized state, used to check a warm-started strategy against a full replay.
+    [[nodiscard]] uint64_t StateDigest() const {
+        BinWriter w;
+        SaveState(w);
+        Checksum64 c;
+        c.update(w.Buffer().data(), w.Buffer().size());
+        return c.digest();
+    }
+
+//& Intraday checkpoints
+    //? Members tracked by incremental checkpoints, in a stable order.
+    [[nodiscard]] std::vector<IPerSymbol*> CheckpointList() {
+        std::vector<IPerSymbol*> out = MasterList;
+        std::erase(out, static_cast<IPerSymbol*>(&DeferredBars));
+        out.insert(out.end(), {&CurrentDate, &FirstTime, &StartTime, &NoSeq, &Positions});
+        for (auto *i : IndicatorList) i->Members(out);
+        for (auto *f : FilterList) f->Members(out);
+        Series.Members(out);
+        return out;
+    }
+    //? Deferred bars are caught up first rather than journaled, so the records hold fully stepped indicators.
+    size_t Checkpoint(CheckpointJournal &j, const int64_t time) {
+        for (size_t s = 0; s < DeferredBars.size(); ++s) CatchUp(static_cast<int>(s));
+        return j.Append(CheckpointList(), time);
+    }
+    //? Day end: folds the journal into a full snapshot and starts a fresh one. The journal is only truncated
+    //? once SaveSnapshot has durably renamed the new snapshot into place; a failure throws before that.
+    void CompactCheckpoints(CheckpointJournal &j, const std::string &snapshot, const int64_t asOf) {
+        SaveSnapshot(snapshot, asOf);
+        j.Truncate();
+        for (auto *m : CheckpointList()) m->ClearDirty();
+    }
+    //? Restores the last full snapshot and replays the journal records after its asOf on top, returns the
+    //? resume time. Stale records left by a crash before Truncate are skipped rather than rolled back onto it.
+    int64_t Restore(const CheckpointJournal &j, const std::string &snapshot) {
+        const int64_t asOf = LoadSnapshot(snapshot);
+        return std::max(asOf, j.Replay(CheckpointList(), asOf));
+    }
+
+//& Dynamic universe
+    //? Adds a symbol at runtime, reusing a freed slot. Every member grows to the new slot count without moving
+    //? existing symbols, then indicators and filters are warmed on a background thread from history(name).
+    //? The symbol is only Active, and so only processed by the readers, once warm. A name that already has a
+    //? slot, Active or still warming from an earlier call, returns that slot and starts nothing.
+    int AddSymbol(const std::string &name, std::function<std::vector<Bar>(const std::string&)> history);
+    //? AddSymbol's two halves for callers that insert the slot themselves (StrategySet): sizes and resets every
+    //? member for the new slot and marks it Warming, then warms it from its history and clears Warming.
+    //? Activating the slot is left to the caller.
+    void AttachSymbol(int sym);
+    void WarmSymbol(std::vector<Bar> &data, int sym);
+    //? Waits for a pending warm of the symbol, then deactivates it and frees its slot for reuse. Closing any
+    //? open position first is up to the caller.
+    void RemoveSymbol(int sym);
+    //& Waits for every background warm started by AddSymbol.
+    void WaitWarm() {
+        for (auto &[s, f] : PendingWarms) if (f.valid()) f.get();
+        PendingWarms.clear();
+    }
+    [[nodiscard]] static bool SymActive(const int sym) {return Universe().Active(sym);}
+    std::vector<std::pair<int, std::future<void>>> PendingWarms;
     void WarmUp(int sym, int64_t startTime = 0, duckdb::Connection *con = nullptr, bool Eval = false);
     void ProcessBar(const Bar &Price, int sym);
     void ProcessCharting(const Bar &Price, int sym);
@@ -83,10 +197,10 @@ public:
     void ReadData(int threadIndex) const;
     static void StartUpdateReader();
 
-//& Charting hooks
-    virtual void pricePlotFirst(double t0, double tN, std::vector<Bar> &data, int sym) {}
-    virtual void pricePlot(double t0, double tN, std::vector<Bar> &data, int sym) {}
-    virtual void volumePlot(double t0, double tN, std::vector<Bar> &data, int sym) {}
+//& Charting hooks, chart holds the symbol's decimated history, query it with ChartMaxPoints for [t0, tN]
+    virtual void pricePlotFirst(double t0, double tN, const PriceChart &chart, int sym) {}
+    virtual void pricePlot(double t0, double tN, const PriceChart &chart, int sym) {}
+    virtual void volumePlot(double t0, double tN, const PriceChart &chart, int sym) {}
 
 //& Getters
     [[nodiscard]] double GetCostBasis(const int sym) {
@@ -116,11 +230,14 @@ public:
 
     std::vector<IIndicator*> &Indicators() {return IndicatorList;}
     std::vector<IFilter*> &Filters() {return FilterList;}
+    std::vector<IPerSymbol*> &Metrics() {return MetricList;}
 
 protected:
 /*  *** STRAT PROTECTED */
 //& Virtual methods with base-wrapped hooks
     virtual void start(int sym) {}
+    //? Runs before a runtime-added symbol is warmed, for per-symbol resources such as normalizers.
+    virtual void newSymbol(int sym) {}
     virtual void newDay(const Bar &Price, int sym) {}
     virtual void processBar(const Bar &Price, int Sym) = 0;
 
@@ -143,6 +260,24 @@ protected:
     std::vector<IIndicator*> IndicatorList{};
     std::vector<IFilter*> FilterList{};
 
+    //? Intermediate series declared by indicators and filters at Init, compiled once all are registered and
+    //? stepped every bar before filters and indicators read it.
+    SeriesGraph Series;
+
+//& Lazy gating
+    //? With LazyGating, filters and the series graph still step every bar but validation runs through Gate.
+    //? Deferrable indicators of a symbol that fails it are not stepped: its bars are buffered in DeferredBars
+    //? and replayed through catchUp when it passes again, or once MaxDeferred bars have queued. Indicators
+    //? whose state is read by other holders between bars (shared ones) opt out and stay stepped.
+    //? MaxDeferredBytes bounds the queues of all slots together, lowering the per-symbol limit as slots grow.
+    FilterGate Gate; // Bound to FilterList after Init, Reorder()ed at day end
+    size_t MaxDeferred = 512;
+    size_t MaxDeferredBytes = size_t{64} << 20;
+    static constexpr size_t DeferredBarBytes = sizeof(Bar) + 32; // Bar plus the heap block of its time string
+    //? Returns whether the symbol passed and IndiStep/processBar should run, deferred bars are caught up first.
+    bool GateIndicators(const Bar &Price, int sym);
+    void CatchUp(int sym);
+
 //& Default period for filter/indicator calculations in bars
     int Period = 14;
 
@@ -166,6 +301,37 @@ public:
 //? Global forge is only used for building global static norm stats.
     TensorForge G_SeqForge{this};
 
+//? Per-day feature sequences computed by previous dataset builds.
+    FeatureCache FeatCache{};
+//? Global salt of every feature key, bump it when feature code changes. The day's bars and its lookback are
+//? hashed into the key separately by FeatureKeyFor, so data revisions never need a bump.
+    uint64_t DataVersion = 0;
+
+//? SetVar parameters the feature depends on plus the strategy scalars every feature sees (period, window,
+//? normalization mode, sequence shape) and the series graph layout, which carries indicator periods.
+    [[nodiscard]] std::string ParamFingerprint(const ISequenceFeature *f) const {
+        std::string fp = "Period=" + std::to_string(Period) + ";windowLength=" + std::to_string(windowLength)
+            + ";symNorm=" + std::to_string(symNorm) + ";rollNorm=" + std::to_string(rollNorm)
+            + ";maxSteps=" + std::to_string(maxSteps) + ";maxSeqPerDay=" + std::to_string(maxSeqPerDay)
+            + ";series=" + std::to_string(Series.Schema()) + ";";
+        const auto add = [&fp](const IPerSymbol *p) {
+            if (const auto d = p->DefString(); !d.empty()) fp += p->Name() + "=" + d + ";";
+        };
+        if (!f->Params.empty()) for (const auto *p : f->Params) add(p);
+        else for (const auto *p : MasterList) add(p);
+        return fp;
+    }
+
+    //& Cache key of the feature's sequence for one symbol-day built from dayBars.
+    //? lookback holds the bars of the preceding windowLength days that warm indicators, filters and rolling
+    //? norms before the day, so a revision there also misses the cache.
+    [[nodiscard]] FeatureKey FeatureKeyFor(const ISequenceFeature *f, const int sym, const int64_t day,
+                                           const std::span<const Bar> dayBars,
+                                           const std::span<const Bar> lookback) const {
+        return {f->Name(), ParamFingerprint(f), Universe().Name(sym), day,
+                Fnv1a().val(DataVersion).val(FeatureKey::DataHash(dayBars)).val(FeatureKey::DataHash(lookback)).h};
+    }
+
     //& Getters
     [[nodiscard]] DataStatus SampleStatus(const int sym) const {
         return TensorStatus[sym];
@@ -195,6 +361,12 @@ protected:
     void ClearSequence(int sym);
     void GetLiveSeq(int sym);
     void GetDatasetSeq(int sym);
+//? Pushes the finished day into each feature/label normalizer's rolling window (rollNorm). Per-symbol
+//? normalizers roll windowLength days, global ones windowLength pooled days of every symbol.
+    void RollNorms(int sym);
+    std::mutex normTex; // Global normalizers are pushed from every reader thread
+//? Builds every collapsed resolution of every feature for the symbol in one pass via Collapser.
+    void CollapseSequences(int sym);
     virtual DataStatus validateSequence(int sym) {return DataStatus::Finished;}
 
     //& Default maximums for tensor allocations
@@ -205,6 +377,9 @@ protected:
     std::vector<ISequenceFeature*> FeatureList{};
     std::vector<ILabel*> LabelList{};
     std::vector<PerSymbol<int64_t>*> EmbeddingList{};
+    //? Registered by the SEQUENCE_FEATURE/LABEL macros for storage outside MasterList (per-symbol normalizers),
+    //? called by AddSymbol with the new slot count and the slot to construct.
+    std::vector<std::function<void(size_t, int)>> SlotHooks{};
 
 //& Internally registered member types
     template<typename T>
@@ -239,6 +414,8 @@ protected:
             (*this)[sym].push_back(step[sym]);
             step.ResetSym(sym);
         }
+        void Grow(const size_t n) override {MemberBase::Grow(n); step.Grow(n);}
+        void ResetSym(const int sym) override {MemberBase::ResetSym(sym); step.ResetSym(sym);}
         PerSymbol<float> step;
     };
 
@@ -272,8 +449,24 @@ public:
     METRIC(TimeStops, int)
     METRIC(Profit, double)
 
+//? Closed trades per symbol, appended by Exit for resampling. Registered, so Reset clears it and
+//? snapshots and checkpoints carry it.
+    MemberBase<std::vector<TradeRecord>> TradeLog{this};
+//? Bars held back from deferrable indicators by lazy gating. Part of the snapshot so a restore can catch up,
+//? left out of CheckpointList since Checkpoint drains them.
+    MemberBase<std::vector<Bar>> DeferredBars{this};
+
+    [[nodiscard]] std::vector<TradeRecord> AllTrades() const {
+        std::vector<TradeRecord> out;
+        for (size_t s = 0; s < TradeLog.size(); ++s)
+            out.insert(out.end(), TradeLog[s].begin(), TradeLog[s].end());
+        std::ranges::sort(out, {}, &TradeRecord::ExitTime);
+        return out;
+    }
+
 //? Charting Data
     bool Charting = false;
+    bool LazyGating = false;
     const Bar *CurrentBar = nullptr;
     std::vector<double> SeqTimes;
     std::vector<std::string> TradeDirections;
@@ -286,7 +479,177 @@ public:
     std::vector<double> targets;
 
     Calc::RollingSum RollVol5 = Calc::RollingSum(5);
-    std::vector<double> RollingVols;
-    std::vector<double> VolumeBars;
+    LodSeries RollingVols;
+    //? Charted symbol's bars, pushed by ProcessCharting, volumes live in PriceSeries.Volume.
+    PriceChart PriceSeries;
+    //? Point budget per series for the plot hooks, the visible range is decimated through LodSeries::QueryTime.
+    size_t ChartMaxPoints = 4000;
 };
 
+//? Covers every registered member, open positions, indicator, filter and normalizer. PrevBar/PrevBars point
+//? into bar storage and are rebuilt by the replay after the snapshot.
+inline void IStrategy::SaveState(BinWriter &w) const {
+    w.val(static_cast<uint32_t>(MasterList.size()));
+    for (const auto *m : MasterList) m->Save(w);
+    CurrentDate.Save(w);
+    FirstTime.Save(w);
+    StartTime.Save(w);
+    NoSeq.Save(w);
+    Positions.Save(w);
+
+    for (const auto *i : IndicatorList) i->Save(w);
+    for (const auto *f : FilterList) f->Save(w);
+    Series.Save(w);
+
+    const auto saveNorms = [&w](const INormalizer *g, const PerSymbol<INormalizer*> *sym) {
+        if (g) g->Save(w);
+        if (sym) for (size_t s = 0; s < sym->size(); ++s) (*sym)[s]->Save(w);
+    };
+    for (const auto *f : FeatureList) {
+        saveNorms(f->NormalizerG, f->NormalizersSym);
+        for (const auto *c : f->CollapsedNormalizersG) c->Save(w);
+        if (f->CollapsedNormalizersSym)
+            for (size_t s = 0; s < f->CollapsedNormalizersSym->size(); ++s)
+                for (const auto *c : (*f->CollapsedNormalizersSym)[s]) c->Save(w);
+    }
+    for (const auto *l : LabelList) saveNorms(l->NormalizerG, l->NormalizersSym);
+}
+
+inline void IStrategy::LoadState(BinReader &r) {
+    uint32_t count = 0;
+    r.val(count);
+    if (count != MasterList.size()) throw std::runtime_error("IStrategy: snapshot member count mismatch");
+    for (auto *m : MasterList) m->Load(r);
+    CurrentDate.Load(r);
+    FirstTime.Load(r);
+    StartTime.Load(r);
+    NoSeq.Load(r);
+    Positions.Load(r);
+
+    for (auto *i : IndicatorList) i->Load(r);
+    for (auto *f : FilterList) f->Load(r);
+    Series.Load(r);
+
+    const auto loadNorms = [&r](INormalizer *g, PerSymbol<INormalizer*> *sym) {
+        if (g) g->Load(r);
+        if (sym) for (size_t s = 0; s < sym->size(); ++s) (*sym)[s]->Load(r);
+    };
+    for (auto *f : FeatureList) {
+        loadNorms(f->NormalizerG, f->NormalizersSym);
+        for (auto *c : f->CollapsedNormalizersG) c->Load(r);
+        if (f->CollapsedNormalizersSym)
+            for (size_t s = 0; s < f->CollapsedNormalizersSym->size(); ++s)
+                for (auto *c : (*f->CollapsedNormalizersSym)[s]) c->Load(r);
+    }
+    for (auto *l : LabelList) loadNorms(l->NormalizerG, l->NormalizersSym);
+}
+
+inline int IStrategy::AddSymbol(const std::string &name, std::function<std::vector<Bar>(const std::string&)> history) {
+    const auto [sym, added] = Universe().Insert(name);
+    if (!added) return sym;
+
+    AttachSymbol(sym);
+    PendingWarms.emplace_back(sym, std::async(std::launch::async, [this, sym, name, history = std::move(history)] {
+        std::vector<Bar> data = history(name);
+        WarmSymbol(data, sym);
+        Universe().Activate(sym);
+    }));
+    return sym;
+}
+
+inline void IStrategy::AttachSymbol(const int sym) {
+    const size_t slots = Universe().Slots();
+
+    std::vector<IPerSymbol*> members = CheckpointList();
+    members.insert(members.end(), {&PrevBar, &PrevBars, &Warming, &TensorStatus, &Sym_SeqForges,
+                                   &CollapsedSeqs, &CollapsedOffsets, &DeferredBars});
+    for (auto *e : EmbeddingList) members.push_back(e);
+
+    for (auto *m : members) {
+        m->Grow(slots);
+        m->ResetSym(sym);
+    }
+    for (const auto &hook : SlotHooks) hook(slots, sym);
+    for (auto *i : IndicatorList) i->ResetSym(sym);
+    if (Ledger) Ledger->Grow(slots);
+    if (Shared) Shared->Grow(slots);
+
+    newSymbol(sym);
+    Warming[sym] = true;
+}
+
+inline void IStrategy::WarmSymbol(std::vector<Bar> &data, const int sym) {
+    IndiWarmUp(data, sym);
+    FiltWarmUp(data, sym);
+    start(sym);
+    Warming[sym] = false;
+}
+
+inline void IStrategy::RemoveSymbol(const int sym) {
+    for (auto it = PendingWarms.begin(); it != PendingWarms.end();) {
+        if (it->first != sym) {++it; continue;}
+        if (it->second.valid()) it->second.get();
+        it = PendingWarms.erase(it);
+    }
+    Universe().Remove(sym);
+}
+
+inline void IStrategy::RollNorms(const int sym) {
+    if (!rollNorm) return;
+    const auto roll = [this, sym](INormalizer *g, PerSymbol<INormalizer*> *syms, std::vector<float> &day) {
+        if (day.empty()) return;
+        const torch::Tensor t = torch::from_blob(day.data(), {static_cast<int64_t>(day.size())}, torch::kFloat);
+        if (syms && (*syms)[sym]) {
+            (*syms)[sym]->EnableRolling(windowLength);
+            (*syms)[sym]->PushDay(t);
+        }
+        if (g) {
+            std::lock_guard lock(normTex);
+            if (!g->Rolling) g->EnableRolling(windowLength);
+            g->PoolDay(t, sym);
+        }
+    };
+    for (auto *f : FeatureList) roll(f->NormalizerG, f->NormalizersSym, f->Get(sym));
+    for (auto *l : LabelList)
+        if (l->Type == typeid(std::vector<float>))
+            roll(l->NormalizerG, l->NormalizersSym, *static_cast<std::vector<float>*>(l->Get(sym)));
+}
+
+inline void IStrategy::CollapseSequences(const int sym) {
+    if (!GenerateCollapsed) return;
+    std::vector<const std::vector<float>*> base;
+    std::vector<Reduce> reduce;
+    std::vector<size_t> lengths;
+    base.reserve(FeatureList.size());
+    reduce.reserve(FeatureList.size());
+    lengths.reserve(FeatureList.size());
+    for (auto *f : FeatureList) {
+        base.push_back(&f->Get(sym));
+        reduce.push_back(f->CollapseReduce);
+        lengths.push_back(base.back()->size());
+    }
+    auto &offsets = CollapsedOffsets[sym];
+    offsets = Collapser.Layout(lengths);
+    auto &out = CollapsedSeqs[sym];
+    out.resize(offsets.back()); // Keeps its capacity from the previous sequence
+    Collapser.Run(base, reduce, out.data(), offsets);
+}
+
+inline bool IStrategy::GateIndicators(const Bar &Price, const int sym) {
+    if (!LazyGating || Charting || Warming[sym] || Gate.Validate(sym)) {
+        CatchUp(sym);
+        return true;
+    }
+    for (auto *i : IndicatorList) if (!i->deferrable()) i->step(Price, sym, false);
+    DeferredBars[sym].push_back(Price);
+    const size_t budget = MaxDeferredBytes / (std::max<size_t>(1, Universe().Slots()) * DeferredBarBytes);
+    if (DeferredBars[sym].size() >= std::clamp<size_t>(budget, 1, MaxDeferred)) CatchUp(sym);
+    return false;
+}
+
+inline void IStrategy::CatchUp(const int sym) {
+    const auto &bars = std::as_const(DeferredBars)[sym];
+    if (bars.empty()) return;
+    for (auto *i : IndicatorList) if (i->deferrable()) i->catchUp(bars, sym);
+    std::vector<Bar>().swap(DeferredBars[sym]);
+}
\ No newline at end of file
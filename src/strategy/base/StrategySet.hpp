@@ -0,0 +1,85 @@
+#pragma once
+
+#include <IStrategy.hpp>
+
+//? Several strategies on one feed sharing one IndicatorRegistry. Strategies are constructed inside the
+//? registry's scope, so indicators declared with SHARED_INDICATOR are computed once however many strategies
+//? hold them, and their intermediate series share one graph. Shared indicator state is reset, saved and grown
+//? here once rather than by each holder.
+class StrategySet {
+public:
+    //? Builds a strategy with make() while the set's registry is in scope and adds it.
+    std::shared_ptr<IStrategy> Add(const std::function<std::shared_ptr<IStrategy>()> &make) {
+        IndicatorRegistry::Scope scope(registry);
+        strats.push_back(make());
+        return strats.back();
+    }
+    void Clear() {strats.clear();}
+
+    void ProcessBar(const Bar &Price, const int sym) {
+        for (const auto &s : strats) s->ProcessBar(Price, sym);
+    }
+
+    void WarmUp(const int sym, const int64_t startTime = 0, duckdb::Connection *con = nullptr, const bool Eval = false) {
+        for (const auto &s : strats) s->WarmUp(sym, startTime, con, Eval);
+    }
+
+    void Reset() {
+        registry.ResetAll();
+        for (const auto &s : strats) s->Reset();
+    }
+
+    //? Adds a symbol for every strategy of the set. The slot is attached to each strategy up front, then one
+    //? background task fetches history(name) once, warms every strategy in turn and activates the slot, so
+    //? shared indicators are warmed by a single thread and a half warmed symbol is never processed.
+    int AddSymbol(const std::string &name, const std::function<std::vector<Bar>(const std::string&)> &history) {
+        const auto [sym, added] = Universe().Insert(name);
+        if (!added) return sym;
+        registry.Grow(Universe().Slots());
+        registry.ResetSym(sym);
+        for (const auto &s : strats) s->AttachSymbol(sym);
+        PendingWarms.emplace_back(sym, std::async(std::launch::async, [strats = strats, sym, name, history] {
+            std::vector<Bar> data = history(name);
+            for (const auto &s : strats) s->WarmSymbol(data, sym);
+            Universe().Activate(sym);
+        }));
+        return sym;
+    }
+    //? Waits for a pending warm of the symbol, then deactivates it and frees its slot for reuse.
+    void RemoveSymbol(const int sym) {
+        for (auto it = PendingWarms.begin(); it != PendingWarms.end();) {
+            if (it->first != sym) {++it; continue;}
+            if (it->second.valid()) it->second.get();
+            it = PendingWarms.erase(it);
+        }
+        Universe().Remove(sym);
+    }
+    //& Waits for every background warm started by AddSymbol.
+    void WaitWarm() {
+        for (auto &[s, f] : PendingWarms) if (f.valid()) f.get();
+        PendingWarms.clear();
+    }
+
+//& Shared state, saved next to the per strategy snapshots
+    void SaveShared(BinWriter &w) const {registry.Save(w);}
+    void LoadShared(BinReader &r) {registry.Load(r);}
+    void Members(std::vector<IPerSymbol*> &out) {registry.Members(out);}
+
+    [[nodiscard]] size_t size() const {return strats.size();}
+    [[nodiscard]] bool empty() const {return strats.empty();}
+    std::shared_ptr<IStrategy> &operator[](const size_t i) {return strats[i];}
+    auto begin() {return strats.begin();}
+    auto end() {return strats.end();}
+
+    void PrintSharing() const {
+        const auto [unique, refs] = registry.Usage();
+        auto out = ibat::sout;
+        out << PURPLE << "Shared indicators: " << RES << unique << " computed for " << refs << " references across "
+            << strats.size() << " strategies" << std::endl;
+    }
+
+private:
+    IndicatorRegistry registry;
+    std::vector<std::shared_ptr<IStrategy>> strats;
+    std::vector<std::pair<int, std::future<void>>> PendingWarms;
+};
\ No newline at end of file
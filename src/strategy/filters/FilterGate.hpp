@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <numeric>
+
+#include <IFilter.hpp>
+
+//? Adaptive short-circuit validation over a strategy's filters. Each filter keeps an EWMA of its validate()
+//? cost and pass rate, sampled every SampleEvery calls, and filters are evaluated cheapest-to-reject first,
+//? ordered by cost / (1 - pass rate). Pass rates are conditional on the filters ahead passing, which is the
+//? quantity the ordering needs.
+class FilterGate {
+public:
+    static constexpr uint64_t SampleEvery = 16;
+    static constexpr double Alpha = 0.05;
+
+    void Bind(const std::vector<IFilter*> &list) {
+        filters = list;
+        stats = std::make_unique<Stat[]>(filters.size());
+        order.resize(filters.size());
+        std::iota(order.begin(), order.end(), 0);
+    }
+
+    //& True when every filter passes, stops at the first rejection.
+    bool Validate(const int sym) {
+        for (const size_t i : order) {
+            Stat &s = stats[i];
+            const bool sample = s.calls.fetch_add(1, std::memory_order_relaxed) % SampleEvery == 0;
+            if (!sample) {
+                if (!filters[i]->validate(sym)) return false;
+                continue;
+            }
+            const auto t0 = std::chrono::steady_clock::now();
+            const bool ok = filters[i]->validate(sym);
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            // Racy read-modify-write on purpose, a lost sample only slows the average down
+            s.cost.store(s.cost.load(std::memory_order_relaxed) * (1 - Alpha) + ns * Alpha, std::memory_order_relaxed);
+            s.pass.store(s.pass.load(std::memory_order_relaxed) * (1 - Alpha) + (ok ? Alpha : 0.0),
+                         std::memory_order_relaxed);
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    //& Re-sorts the evaluation order from the current estimates.
+    //! Not thread safe with Validate, call at a quiescent point such as day end.
+    void Reorder() {
+        std::ranges::stable_sort(order, {}, [this](const size_t i) {return Score(i);});
+    }
+
+    [[nodiscard]] double Score(const size_t i) const {
+        const double cost = stats[i].cost.load(std::memory_order_relaxed);
+        const double reject = 1.0 - stats[i].pass.load(std::memory_order_relaxed);
+        return cost / std::max(reject, 1e-3);
+    }
+
+    [[nodiscard]] const std::vector<size_t> &Order() const {return order;}
+
+    void Print() const {
+        auto out = ibat::sout;
+        out << PURPLE << "Filter order" << RES << std::endl;
+        for (const size_t i : order)
+            out << "  #" << i << " cost " << stats[i].cost.load() << "ns pass " << stats[i].pass.load()
+                << " calls " << stats[i].calls.load() << std::endl;
+    }
+
+private:
+    struct alignas(64) Stat {
+        std::atomic<double> cost{1.0};
+        std::atomic<double> pass{0.5};
+        std::atomic<uint64_t> calls{0};
+    };
+
+    std::vector<IFilter*> filters;
+    std::unique_ptr<Stat[]> stats;
+    std::vector<size_t> order;
+};
\ No newline at end of file
@@ -3,33 +3,51 @@
 #include <IFilter.hpp>
 #include <PerSymbol.hpp>
 #include <Calc.hpp>
+#include <SeriesGraph.hpp>
 
 namespace filt {
     struct RollingVolume final : IFilter {
         explicit RollingVolume(int period);
         void init() override;
         void setThresh(long double t, int sym) override;
-        void step(const Bar &b, int sym) override;
-        bool validate(int sym) override;
-        void warmUp(std::vector<Bar> &data, int sym) override;
-        long double getValue(int sym) override;
+        //? The 5 bar volume sum lives in the graph, stepped and warmed by the strategy.
+        void step(const Bar &b, int sym) override {}
+        bool validate(const int sym) override {return getValue(sym) > thresh[sym];}
+        void warmUp(std::vector<Bar> &data, int sym) override {}
+        long double getValue(const int sym) override {return graph ? graph->Value(volume, sym) : 0;}
 
-        void ResetAll() override;
+        void ResetAll() override {thresh.ResetAll();}
+
+        void Save(BinWriter &w) const override {thresh.Save(w);}
+        void Load(BinReader &r) override {thresh.Load(r);}
+        void Members(std::vector<IPerSymbol*> &out) override {out.push_back(&thresh);}
+        void declare(SeriesGraph &g) override {volume = g.Require(g.RollingSum(g.Volume(), 5));}
+
+        SeriesGraph::Node volume = -1;
 
         PerSymbol<long double> thresh;
-        PerSymbol<Calc::RollingSum> rollingVols{Calc::RollingSum(5)};
     };
 
     struct NR7 final : IFilter {
         explicit NR7();
-        bool validate(int sym) override;
-        void step(const Bar &b, int sym) override;
-        void warmUp(std::vector<Bar> &data, int sym) override;
+        //? Passes when the last completed session had the narrowest range of the last seven.
+        bool validate(const int sym) override {
+            return graph && graph->Count(narrowest, sym) >= 7 && graph->Value(last, sym) <= graph->Value(narrowest, sym);
+        }
+        //? Session high/low and the seven session window live in the graph, stepped and warmed by the strategy.
+        void step(const Bar &b, int sym) override {}
+        void warmUp(std::vector<Bar> &data, int sym) override {}
+
+        //? Nothing of its own to reset, the strategy resets the graph's session state.
+        void ResetAll() override {}
 
-        void ResetAll() override;
+        void declare(SeriesGraph &g) override {
+            const SeriesGraph::Node range = g.Diff(g.SessionMax(g.High()), g.SessionMin(g.Low()));
+            last = g.Require(g.PrevSession(range));
+            narrowest = g.Require(g.SessionRollingMin(range, 7));
+        }
 
-        PerSymbol<std::deque<double>> ranges;
-        PerSymbol<Date> currentDates{Date(0)};
-        PerSymbol<std::pair<double, double>> highLows;
+        SeriesGraph::Node last = -1;
+        SeriesGraph::Node narrowest = -1;
     };
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <BOT.hpp>
+#include <Serial.hpp>
+#include <SeriesGraph.hpp>
+
+struct IPerSymbol;
 
 struct IFilter {
     int Period;
@@ -19,4 +23,17 @@ struct IFilter {
 
     virtual void setThresh(long double t, int sym) {}
     virtual long double getValue(int sym) { return 0; }
+
+    virtual void Save(BinWriter &w) const {}
+    virtual void Load(BinReader &r) {}
+    virtual void Members(std::vector<IPerSymbol*> &out) {}
+
+    //? Declares the shared series this filter reads, called from Init before the graph is compiled.
+    void Declare(SeriesGraph &g) {
+        const size_t before = g.Declared();
+        declare(g);
+        if (g.Declared() > before) graph = &g;
+    }
+    virtual void declare(SeriesGraph &g) {}
+    const SeriesGraph *graph = nullptr; // Set only when the filter reads graph nodes
 };
@@ -2,15 +2,19 @@
 
 #include <BOT.hpp>
 #include <Calc.hpp>
+#include <Serial.hpp>
+#include <SeriesGraph.hpp>
+#include <LodSeries.hpp>
 
 template<typename T>
 struct PerSymbol;
+struct IPerSymbol;
 
 struct IIndicator {
     const bool Daily;
     const bool Chart;
     int Period;
-    std::vector<double> chartVals;
+    LodSeries chartVals;
     std::string name;
 
     explicit IIndicator(bool daily, bool chart, int period = 0);
@@ -22,6 +26,23 @@ struct IIndicator {
     virtual void ResetAll() = 0;
     virtual void ResetSym(int sym) {}
     virtual void warmUp(std::vector<Bar> &data, int sym) {}
+    //? Steps a burst of bars deferred while the symbol was gated out, override with a vectorized pass.
+    virtual void catchUp(const std::vector<Bar> &bars, const int sym) {for (const Bar &b : bars) step(b, sym, false);}
+    //? Whether steps may be held back and replayed by catchUp, false when others read the state between bars.
+    [[nodiscard]] virtual bool deferrable() const {return true;}
 
     virtual double getValue(int sym) { return 0; }
+
+    virtual void Save(BinWriter &w) const {}
+    virtual void Load(BinReader &r) {}
+    virtual void Members(std::vector<IPerSymbol*> &out) {}
+
+    //? Declares the shared series this indicator reads, called from Init before the graph is compiled.
+    void Declare(SeriesGraph &g) {
+        const size_t before = g.Declared();
+        declare(g);
+        if (g.Declared() > before) graph = &g;
+    }
+    virtual void declare(SeriesGraph &g) {}
+    const SeriesGraph *graph = nullptr; // Set only when the indicator reads graph nodes
 };
@@ -1,33 +1,49 @@
 #pragma once
 #include <IIndicator.hpp>
 #include <PerSymbol.hpp>
+#include <SeriesGraph.hpp>
 
 namespace indi {
     struct ATR final : IIndicator {
         explicit ATR(int period = 0);
 
-        void step(const Bar &b, int sym, bool charting) override;
-        void warmUp(std::vector<Bar> &data, int sym) override;
+        //? State lives in the graph's Wilder node, stepped and warmed by the owner of the graph.
+        void step(const Bar &b, int sym, const bool charting) override {
+            if (charting && Chart) chartVals.push_back(getValue(sym));
+        }
+        void catchUp(const std::vector<Bar> &bars, int sym) override {}
 
-        double getValue(int sym) override;
+        double getValue(const int sym) override {return graph ? graph->Value(atr, sym) : 0;}
 
-        void ResetAll() override;
+        //? Nothing of its own to reset, the graph owner (strategy or registry) resets the Wilder node.
+        void ResetAll() override {}
 
-        PerSymbol<double> prevCloses;
-        PerSymbol<double> atrValues;
+        void declare(SeriesGraph &g) override {
+            if (Period <= 0) throw std::runtime_error("ATR: period must be positive, got " + std::to_string(Period));
+            atr = g.Require(g.Wilder(g.TrueRange(), Period));
+        }
+
+        SeriesGraph::Node atr = -1;
     };
 
     struct VWAP final : IIndicator {
         explicit VWAP(int period = 0);
 
-        void step(const Bar &b, int sym, bool charting) override;
+        //? Session sums live in the graph, stepped and warmed by the owner of the graph.
+        void step(const Bar &b, int sym, const bool charting) override {
+            if (charting && Chart) chartVals.push_back(getValue(sym));
+        }
+        void catchUp(const std::vector<Bar> &bars, int sym) override {}
+
+        double getValue(const int sym) override {return graph ? graph->Value(vwap, sym) : 0;}
 
-        double getValue(int sym) override;
+        //? Nothing of its own to reset, the graph owner (strategy or registry) resets the session sums.
+        void ResetAll() override {}
 
-        void ResetAll() override;
-        void ResetSym(int sym) override;
+        void declare(SeriesGraph &g) override {
+            vwap = g.Require(g.Ratio(g.SessionSum(g.PriceVolume()), g.SessionSum(g.Volume())));
+        }
 
-        PerSymbol<double> cumuPriceVol;
-        PerSymbol<double> cumuVol;
+        SeriesGraph::Node vwap = -1;
     };
 }
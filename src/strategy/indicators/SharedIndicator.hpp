@@ -0,0 +1,230 @@
+#pragma once
+
+#include <IIndicator.hpp>
+#include <PerSymbol.hpp>
+
+//? Indicators shared by the strategies of one StrategySet, keyed by type and constructor arguments.
+//? Strategies built while a registry is in Scope get the same instance for equal SHARED_INDICATOR declarations;
+//? outside a scope (single strategy, walk-forward forks, replay checks) each strategy gets a private one.
+//? Steps are deduplicated by the bar itself: the first holder to see a bar for a symbol steps the indicator,
+//? later holders given the same bar skip, so it holds for every driver (live, backtest, walk-forward).
+//? Shared indicators declare into one series graph per registry, so equal intermediate series collapse across
+//? all of them and are stepped once per bar. Declaring new series recompiles it and clears its state, so
+//? strategies are added to a set before it is warmed. Private entries own their graph.
+//! Assumes each symbol is stepped and warmed by one thread at a time across every strategy of the set: the
+//! reader threads partition symbols, and StrategySet warms a new symbol for all its strategies in one task.
+class IndicatorRegistry {
+public:
+    //? Series graph with the per-symbol bookkeeping to step it once per bar however many holders forward it.
+    struct SeriesDriver {
+        SeriesGraph graph;
+        PerSymbol<uint64_t> stepped{0};
+        PerSymbol<uint64_t> warmed{0};
+        PerSymbol<uint64_t> day{0};
+
+        void Declare(IIndicator &ind) {
+            const size_t before = graph.Declared();
+            ind.Declare(graph);
+            if (graph.Declared() > before) graph.Compile();
+        }
+        void Step(const Bar &b, const int sym) {
+            if (graph.Declared() == 0) return;
+            const uint64_t key = BarKey(b);
+            if (stepped[sym] == key) return;
+            stepped[sym] = key;
+            const uint64_t d = Fnv1a().str(b.time.substr(0, 8)).h;
+            graph.Step(b, sym, day[sym] != 0 && day[sym] != d);
+            day[sym] = d;
+        }
+        void WarmUp(const std::vector<Bar> &data, const int sym) {
+            if (graph.Declared() == 0) return;
+            const uint64_t key = data.empty() ? 1 : BarKey(data.back()) ^ data.size();
+            if (warmed[sym] == key) return;
+            warmed[sym] = key;
+            graph.WarmUp(data, sym);
+            if (!data.empty()) {
+                day[sym] = Fnv1a().str(data.back().time.substr(0, 8)).h;
+                stepped[sym] = BarKey(data.back());
+            }
+        }
+
+        void Grow(const size_t slots) {graph.Grow(slots); stepped.Grow(slots); warmed.Grow(slots); day.Grow(slots);}
+        void ResetSym(const int sym) {graph.ResetSym(sym); stepped.ResetSym(sym); warmed.ResetSym(sym); day.ResetSym(sym);}
+        void ResetAll() {graph.ResetAll(); stepped.ResetAll(); warmed.ResetAll(); day.ResetAll();}
+        void Save(BinWriter &w) const {graph.Save(w); stepped.Save(w); day.Save(w);}
+        void Load(BinReader &r) {graph.Load(r); stepped.Load(r); day.Load(r);}
+        void Members(std::vector<IPerSymbol*> &out) {graph.Members(out); out.insert(out.end(), {&stepped, &warmed, &day});}
+    };
+
+    struct Entry {
+        std::string key;
+        std::unique_ptr<IIndicator> ind;
+        std::shared_ptr<SeriesDriver> series; // The registry's for shared entries, its own for private ones
+        PerSymbol<uint64_t> stepped{0};
+        PerSymbol<uint64_t> warmed{0};
+        std::atomic<int> users{0};
+        bool shared = false;
+
+        void bind() {series->Declare(*ind);}
+        void step(const Bar &b, const int sym) {
+            series->Step(b, sym);
+            ind->step(b, sym, false);
+        }
+        void warmUp(std::vector<Bar> &data, const int sym) {
+            series->WarmUp(data, sym);
+            ind->warmUp(data, sym);
+        }
+
+        //? Series state is only included for private entries, the registry handles its shared driver once.
+        void Grow(const size_t slots) {stepped.Grow(slots); warmed.Grow(slots); if (!shared) series->Grow(slots);}
+        void ResetSym(const int sym) {
+            ind->ResetSym(sym); stepped.ResetSym(sym); warmed.ResetSym(sym);
+            if (!shared) series->ResetSym(sym);
+        }
+        void ResetAll() {ind->ResetAll(); stepped.ResetAll(); warmed.ResetAll(); if (!shared) series->ResetAll();}
+        void Save(BinWriter &w) const {ind->Save(w); stepped.Save(w); if (!shared) series->Save(w);}
+        void Load(BinReader &r) {ind->Load(r); stepped.Load(r); if (!shared) series->Load(r);}
+        void Members(std::vector<IPerSymbol*> &out) {
+            ind->Members(out);
+            out.insert(out.end(), {&stepped, &warmed});
+            if (!shared) series->Members(out);
+        }
+    };
+
+    //& Makes strategies constructed on this thread share through reg until the scope ends.
+    struct Scope {
+        explicit Scope(IndicatorRegistry &reg) : prev(current) {current = &reg;}
+        ~Scope() {current = prev;}
+        Scope(const Scope&) = delete;
+        Scope &operator=(const Scope&) = delete;
+    private:
+        IndicatorRegistry *prev;
+    };
+
+    [[nodiscard]] static IndicatorRegistry *Current() {return current;}
+
+    //& Entry from the registry in scope, or a private one when there is none.
+    template<typename I, typename... Args>
+    static std::shared_ptr<Entry> Make(Args&&... args) {
+        if (current) return current->Acquire<I>(std::forward<Args>(args)...);
+        auto e = std::make_shared<Entry>();
+        e->ind = std::make_unique<I>(std::forward<Args>(args)...);
+        e->series = std::make_shared<SeriesDriver>();
+        e->bind();
+        e->users = 1;
+        return e;
+    }
+
+    template<typename I, typename... Args>
+    std::shared_ptr<Entry> Acquire(Args&&... args) {
+        std::ostringstream k;
+        k << typeid(I).name() << '(';
+        ((k << std::setprecision(17) << args << ','), ...);
+        k << ')';
+
+        std::lock_guard lock(mtx);
+        auto &e = entries[k.str()];
+        if (!e) {
+            e = std::make_shared<Entry>();
+            e->key = k.str();
+            e->ind = std::make_unique<I>(std::forward<Args>(args)...);
+            e->series = series;
+            e->shared = true;
+            e->bind();
+        }
+        ++e->users;
+        return e;
+    }
+
+    //& Bar identity used for step deduplication.
+    static uint64_t BarKey(const Bar &b) {
+        return Fnv1a().str(b.time).val(b.open).val(b.high).val(b.low).val(b.close).h | 1;
+    }
+
+    //& Set level state management, shared indicators are reset, saved and checkpointed here exactly once.
+    void Grow(const size_t slots) {
+        std::lock_guard lock(mtx);
+        series->Grow(slots);
+        for (auto &[k, e] : entries) e->Grow(slots);
+    }
+    void ResetSym(const int sym) {series->ResetSym(sym); for (auto &[k, e] : entries) e->ResetSym(sym);}
+    void ResetAll() {series->ResetAll(); for (auto &[k, e] : entries) e->ResetAll();}
+    void Save(BinWriter &w) const {
+        series->Save(w);
+        w.val(static_cast<uint32_t>(entries.size()));
+        for (const auto &[k, e] : entries) {w.writeValue(k); e->Save(w);}
+    }
+    void Load(BinReader &r) {
+        series->Load(r);
+        uint32_t count = 0;
+        r.val(count);
+        if (count != entries.size()) throw std::runtime_error("IndicatorRegistry: snapshot entry count mismatch");
+        for (auto &[k, e] : entries) {
+            std::string key;
+            r.readValue(key);
+            if (key != k) throw std::runtime_error("IndicatorRegistry: snapshot has " + key + " where " + k + " was expected");
+            e->Load(r);
+        }
+    }
+    void Members(std::vector<IPerSymbol*> &out) {series->Members(out); for (auto &[k, e] : entries) e->Members(out);}
+
+    //& The set wide graph the shared indicators declare into.
+    [[nodiscard]] const SeriesGraph &Series() const {return series->graph;}
+
+    //& Unique indicators alive and total strategy references to them.
+    [[nodiscard]] std::pair<size_t, size_t> Usage() const {
+        std::lock_guard lock(mtx);
+        size_t refs = 0;
+        for (const auto &[k, e] : entries) refs += e->users;
+        return {entries.size(), refs};
+    }
+
+private:
+    static inline thread_local IndicatorRegistry *current = nullptr;
+
+    mutable std::mutex mtx;
+    std::shared_ptr<SeriesDriver> series = std::make_shared<SeriesDriver>();
+    std::map<std::string, std::shared_ptr<Entry>> entries;
+};
+
+//? Strategy side handle of a possibly shared indicator. Reads are forwarded and steps deduplicated per bar.
+//? For shared entries reset, save and checkpoint membership belong to the registry, so holders contribute nothing.
+struct SharedIndicator final : IIndicator {
+    explicit SharedIndicator(std::shared_ptr<IndicatorRegistry::Entry> entry)
+        : IIndicator(entry->ind->Daily, entry->ind->Chart, entry->ind->Period), entry(std::move(entry)) {}
+    ~SharedIndicator() override {--entry->users;}
+
+    void step(const Bar &b, const int sym, const bool charting) override {
+        const uint64_t key = IndicatorRegistry::BarKey(b);
+        if (entry->stepped[sym] != key) {
+            entry->stepped[sym] = key;
+            entry->step(b, sym);
+        }
+        if (charting && Chart) chartVals.push_back(entry->ind->getValue(sym));
+    }
+
+    void warmUp(std::vector<Bar> &data, const int sym) override {
+        const uint64_t key = data.empty() ? 1 : IndicatorRegistry::BarKey(data.back()) ^ data.size();
+        if (entry->warmed[sym] == key) return;
+        entry->warmed[sym] = key;
+        entry->warmUp(data, sym);
+        if (!data.empty()) entry->stepped[sym] = IndicatorRegistry::BarKey(data.back());
+    }
+
+    double getValue(const int sym) override {return entry->ind->getValue(sym);}
+    //? Other holders read the shared state every bar, and replaying older bars would step it backwards.
+    [[nodiscard]] bool deferrable() const override {return !entry->shared;}
+
+    void ResetAll() override {if (!entry->shared) entry->ResetAll();}
+    void ResetSym(const int sym) override {if (!entry->shared) entry->ResetSym(sym);}
+
+    void Save(BinWriter &w) const override {if (!entry->shared) entry->Save(w);}
+    void Load(BinReader &r) override {if (!entry->shared) entry->Load(r);}
+    void Members(std::vector<IPerSymbol*> &out) override {if (!entry->shared) entry->Members(out);}
+
+    [[nodiscard]] bool Shared() const {return entry->shared;}
+    [[nodiscard]] const std::string &Key() const {return entry->key;}
+
+private:
+    std::shared_ptr<IndicatorRegistry::Entry> entry;
+};
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <TemporalData.hpp>
+#include <Serial.hpp>
 
 struct NormalizationStats final : DataStatsImpl {
     explicit NormalizationStats(const DataStatsImpl &ref) : DataStatsImpl(ref) {}
@@ -77,9 +78,327 @@ struct NormalizationStats final : DataStatsImpl {
     }
 };
 
+//? Mergeable partial statistics for a single day of observations, kept per day in the rolling ring.
+struct DayPartial {
+    using Sketch = decltype(DataStatsImpl::kllMed);
+
+    int64_t n = 0;
+    double mean = 0;
+    double M2 = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double l1 = 0;
+    double l2sq = 0;
+    Sketch sketch{};
+
+    void step(const double* ptr, const int64_t xN) {
+        for (int64_t i = 0; i < xN; i++) {
+            const double v = ptr[i];
+            ++n;
+            const double delta = v - mean;
+            mean += delta / static_cast<double>(n);
+            M2 += delta * (v - mean);
+            min = std::min(min, v);
+            max = std::max(max, v);
+            l1 += std::abs(v);
+            l2sq += v * v;
+            sketch.update(v);
+        }
+    }
+
+    //& Chan et al. parallel combination of two partials.
+    void merge(const DayPartial &o) {
+        if (o.n == 0) return;
+        if (n == 0) {*this = o; return;}
+        const auto Nd = static_cast<double>(n);
+        const auto On = static_cast<double>(o.n);
+        const double total = Nd + On;
+        const double delta = o.mean - mean;
+        mean += delta * (On / total);
+        M2 += o.M2 + delta * delta * (Nd * On / total);
+        n += o.n;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+        l1 += o.l1;
+        l2sq += o.l2sq;
+        sketch.merge(o.sketch);
+    }
+
+    void Save(BinWriter &w) const {
+        w.val(n); w.val(mean); w.val(M2); w.val(min); w.val(max); w.val(l1); w.val(l2sq);
+        w.writeValue(sketch.serialize());
+    }
+    void Load(BinReader &r) {
+        r.val(n); r.val(mean); r.val(M2); r.val(min); r.val(max); r.val(l1); r.val(l2sq);
+        std::vector<uint8_t> bytes;
+        r.readValue(bytes);
+        sketch = Sketch::deserialize(bytes.data(), bytes.size());
+    }
+};
+
+//? Sliding window of DayPartial stats. Pushing a day adds one partial and evicts the oldest,
+//? so moments update in O(1) and min/max in amortized O(1) regardless of the window's sample count.
+//? Global normalizers pool every symbol's day into one open partial instead, see pool().
+struct RollingNormalizationStats {
+    explicit RollingNormalizationStats(const size_t window = 10) {SetWindow(window);}
+
+    void SetWindow(const size_t window) {
+        ring.assign(std::max<size_t>(window, 1), DayPartial());
+        Clear();
+    }
+
+    void Clear() {
+        head = 0; count = 0; seq = 0; evictions = 0;
+        total = DayPartial();
+        minQ.clear(); maxQ.clear();
+        open = DayPartial();
+        pooled.clear();
+    }
+
+    [[nodiscard]] size_t Window() const {return ring.size();}
+    [[nodiscard]] size_t Days() const {return count;}
+
+    void Save(BinWriter &w) const {
+        w.val(static_cast<uint64_t>(ring.size()));
+        w.val(static_cast<uint64_t>(head));
+        w.val(static_cast<uint64_t>(count));
+        w.val(seq);
+        w.val(evictions);
+        for (size_t i = 0; i < count; ++i) ring[(head + i) % ring.size()].Save(w);
+        total.Save(w);
+        w.writeValue(minQ);
+        w.writeValue(maxQ);
+        open.Save(w);
+        w.writeValue(pooled);
+    }
+    void Load(BinReader &r) {
+        uint64_t window = 0, h = 0, c = 0;
+        r.val(window); r.val(h); r.val(c);
+        if (!r.ok() || window == 0 || c > window) throw std::runtime_error("RollingNormalizationStats: corrupt window");
+        ring.assign(window, DayPartial());
+        head = h % window;
+        count = c;
+        r.val(seq);
+        r.val(evictions);
+        for (size_t i = 0; i < count; ++i) ring[(head + i) % ring.size()].Load(r);
+        total.Load(r);
+        r.readValue(minQ);
+        r.readValue(maxQ);
+        open.Load(r);
+        r.readValue(pooled);
+    }
+
+    void push(const torch::Tensor &_x) {
+        const torch::Tensor &x = _x.to(torch::kDouble).contiguous();
+        DayPartial day;
+        day.step(x.data_ptr<double>(), x.numel());
+        push(std::move(day));
+    }
+
+    void push(DayPartial day) {
+        if (count == ring.size()) evict();
+
+        const size_t slot = (head + count) % ring.size();
+        ring[slot] = std::move(day);
+        ++count;
+
+        const DayPartial &d = ring[slot];
+        add(d);
+        while (!minQ.empty() && minQ.back().second >= d.min) minQ.pop_back();
+        minQ.emplace_back(seq, d.min);
+        while (!maxQ.empty() && maxQ.back().second <= d.max) maxQ.pop_back();
+        maxQ.emplace_back(seq, d.max);
+        ++seq;
+    }
+
+    //& Adds one symbol's day to the open pooled day. A symbol contributing again means the pooled day is over,
+    //& so it is pushed first and a new one opened. Returns whether a day was pushed.
+    bool pool(const torch::Tensor &_x, const int sym) {
+        bool pushed = false;
+        if (static_cast<size_t>(sym) >= pooled.size()) pooled.resize(sym + 1, 0);
+        if (pooled[sym]) {
+            push(std::move(open));
+            open = DayPartial();
+            std::ranges::fill(pooled, 0);
+            pushed = true;
+        }
+        pooled[sym] = 1;
+        const torch::Tensor &x = _x.to(torch::kDouble).contiguous();
+        open.step(x.data_ptr<double>(), x.numel());
+        return pushed;
+    }
+
+    //& Writes the window statistics into the normalizer's stats. Quantiles require merging the
+    //& per-day sketches and are only computed when requested.
+    void publish(NormalizationStats &s, const bool quantiles) const {
+        if (total.n == 0) return;
+
+        const auto set = [](torch::Tensor &t, const double v) {
+            torch::set_out(t, t, torch::tensor(v).to(torch::kDouble));
+        };
+
+        const double lo = minQ.front().second;
+        const double hi = maxQ.front().second;
+        const double variance = total.n > 1 ? total.M2 / static_cast<double>(total.n - 1) : 0.0;
+
+        s.N.fill_(total.n);
+        set(s.mean, total.mean);
+        set(s.M2, total.M2);
+        set(s.min_val, lo);
+        set(s.max_val, hi);
+        set(s.range, hi - lo);
+        set(s.l1_norm, total.l1);
+        set(s.l2_norm, std::sqrt(total.l2sq));
+        set(s.variance, variance);
+        set(s.std_dev, std::sqrt(variance));
+
+        if (!quantiles) return;
+
+        DayPartial::Sketch merged{};
+        for (size_t i = 0; i < count; ++i)
+            merged.merge(ring[(head + i) % ring.size()].sketch);
+        if (merged.is_empty()) return;
+
+        const double med = merged.get_quantile(0.5);
+        set(s.median, med);
+
+        //? MAD is the weighted median of absolute deviations over the merged sketch's retained items.
+        std::vector<std::pair<double, uint64_t>> devs;
+        uint64_t weight = 0;
+        for (const auto &item : merged) {
+            devs.emplace_back(std::abs(item.first - med), item.second);
+            weight += item.second;
+        }
+        std::ranges::sort(devs, {}, &std::pair<double, uint64_t>::first);
+        uint64_t acc = 0;
+        for (const auto &[dev, w] : devs) {
+            acc += w;
+            if (2 * acc >= weight) {set(s.mad, dev); break;}
+        }
+    }
+
+private:
+    void add(const DayPartial &d) {
+        if (d.n == 0) return;
+        const int64_t n = total.n + d.n;
+        const double delta = d.mean - total.mean;
+        total.mean += delta * (static_cast<double>(d.n) / static_cast<double>(n));
+        total.M2 += d.M2 + delta * delta * (static_cast<double>(total.n) * static_cast<double>(d.n) / static_cast<double>(n));
+        total.n = n;
+        total.l1 += d.l1;
+        total.l2sq += d.l2sq;
+    }
+
+    //& Inverse of the Chan combination, removing the oldest day's contribution.
+    void remove(const DayPartial &d) {
+        if (d.n == 0) return;
+        const int64_t n = total.n - d.n;
+        if (n <= 0) {total = DayPartial(); return;}
+        const double mean = (static_cast<double>(total.n) * total.mean - static_cast<double>(d.n) * d.mean) / static_cast<double>(n);
+        const double delta = d.mean - mean;
+        total.M2 -= d.M2 + delta * delta * (static_cast<double>(n) * static_cast<double>(d.n) / static_cast<double>(total.n));
+        total.M2 = std::max(total.M2, 0.0);
+        total.mean = mean;
+        total.n = n;
+        total.l1 -= d.l1;
+        total.l2sq -= d.l2sq;
+    }
+
+    void evict() {
+        const uint64_t oldest = seq - count;
+        remove(ring[head]);
+        ring[head] = DayPartial();
+        head = (head + 1) % ring.size();
+        --count;
+
+        if (!minQ.empty() && minQ.front().first == oldest) minQ.pop_front();
+        if (!maxQ.empty() && maxQ.front().first == oldest) maxQ.pop_front();
+
+        //! Subtraction accumulates rounding error, re-derive the moments once per full window turnover.
+        if (++evictions % ring.size() == 0) {
+            total = DayPartial();
+            for (size_t i = 0; i < count; ++i)
+                add(ring[(head + i) % ring.size()]);
+        }
+    }
+
+    std::vector<DayPartial> ring;
+    size_t head = 0;
+    size_t count = 0;
+    uint64_t seq = 0;
+    uint64_t evictions = 0;
+    DayPartial total;
+    std::deque<std::pair<uint64_t, double>> minQ;
+    std::deque<std::pair<uint64_t, double>> maxQ;
+    DayPartial open;             // Pooled day still receiving symbols
+    std::vector<uint8_t> pooled; // Slots already in the open pooled day
+};
+
 struct INormalizer {
+    INormalizer() = default;
+    INormalizer(const INormalizer &o) : Stats(o.Stats), Rolling(o.Rolling ? std::make_unique<RollingNormalizationStats>(*o.Rolling) : nullptr) {}
+    INormalizer &operator=(const INormalizer &o) {
+        Stats = o.Stats;
+        Rolling = o.Rolling ? std::make_unique<RollingNormalizationStats>(*o.Rolling) : nullptr;
+        return *this;
+    }
     virtual ~INormalizer() = default;
     virtual void Normalize(torch::Tensor e) = 0;
     virtual void DeNormalize(torch::Tensor e) = 0;
     NormalizationStats Stats = NormalizationStats();
+
+//& Rolling normalization, used when rollNorm is set with windowLength days.
+    //? Only allocated by EnableRolling, normalizers of strategies without rollNorm carry no day ring.
+    std::unique_ptr<RollingNormalizationStats> Rolling;
+    [[nodiscard]] virtual bool RollsQuantiles() const {return false;}
+    void EnableRolling(const size_t window) {
+        if (!Rolling) Rolling = std::make_unique<RollingNormalizationStats>(window);
+        else if (Rolling->Window() != window) Rolling->SetWindow(window);
+    }
+    void PushDay(const torch::Tensor &day) {
+        if (!Rolling) throw std::runtime_error("INormalizer: PushDay before EnableRolling");
+        Rolling->push(day);
+        Rolling->publish(Stats, RollsQuantiles());
+    }
+    //? Global normalizers, one day of one symbol. Stats are only republished when a pooled day closes,
+    //? so the quantile sketches are merged once per day rather than once per symbol.
+    void PoolDay(const torch::Tensor &day, const int sym) {
+        if (!Rolling) throw std::runtime_error("INormalizer: PoolDay before EnableRolling");
+        if (Rolling->pool(day, sym)) Rolling->publish(Stats, RollsQuantiles());
+    }
+
+//& Snapshot of the normalization statistics, including the quantile sketches and the rolling window.
+    void Save(BinWriter &w) const {
+        torch::serialize::OutputArchive ar;
+        Stats.save(ar);
+        std::ostringstream os;
+        ar.save_to(os);
+        w.writeValue(os.str());
+        w.writeValue(Stats.kllMed.serialize());
+        w.writeValue(Stats.kllDev.serialize());
+        w.val(Stats.medianFixed);
+        w.val(static_cast<uint8_t>(Rolling != nullptr));
+        if (Rolling) Rolling->Save(w);
+    }
+
+    void Load(BinReader &r) {
+        std::string archive;
+        r.readValue(archive);
+        std::istringstream is(archive);
+        torch::serialize::InputArchive ar;
+        ar.load_from(is);
+        Stats.load(ar);
+
+        std::vector<uint8_t> sketch;
+        r.readValue(sketch);
+        Stats.kllMed = DayPartial::Sketch::deserialize(sketch.data(), sketch.size());
+        r.readValue(sketch);
+        Stats.kllDev = DayPartial::Sketch::deserialize(sketch.data(), sketch.size());
+        r.val(Stats.medianFixed);
+        uint8_t rolling = 0;
+        r.val(rolling);
+        if (!rolling) {Rolling.reset(); return;}
+        if (!Rolling) Rolling = std::make_unique<RollingNormalizationStats>();
+        Rolling->Load(r);
+    }
 };
\ No newline at end of file
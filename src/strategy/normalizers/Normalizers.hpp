@@ -22,6 +22,8 @@ struct ZScore final : INormalizer {
 struct Robust final : INormalizer {
     using INormalizer::Stats;
 
+    [[nodiscard]] bool RollsQuantiles() const override {return true;}
+
     void Normalize(torch::Tensor e) override {
         torch::sub_out(e, e, Stats.median);
         torch::div_out(e, e, (Stats.mad + 1e-7) * 1.4826);
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <Serial.hpp>
+#include <Jobs.hpp>
+
+//? Streaming, mergeable first and second moments over d columns.
+//? A single pass accumulates everything needed for covariance, correlation and ridge normal equations.
+struct CoMoments {
+    explicit CoMoments(const size_t dims = 0)
+        : d(dims), mean(dims, 0.0), C(dims * dims, 0.0) {}
+
+    size_t d;
+    int64_t n = 0;
+    std::vector<double> mean;
+    std::vector<double> C;  // Row-major co-moment sum of (x - mean)(x - mean)^T
+
+    //& Accumulates a row-major block of rows by centering it on its own mean and merging.
+    //& The inner product is tiled over rows so the block stays cache resident.
+    void stepBlock(const float* rows, const size_t nRows) {
+        if (nRows == 0) return;
+
+        CoMoments b(d);
+        b.n = static_cast<int64_t>(nRows);
+        for (size_t r = 0; r < nRows; ++r)
+            for (size_t i = 0; i < d; ++i)
+                b.mean[i] += rows[r * d + i];
+        for (auto &m : b.mean) m /= static_cast<double>(nRows);
+
+        constexpr size_t Tile = 64;
+        std::vector<double> centered(Tile * d);
+        for (size_t r0 = 0; r0 < nRows; r0 += Tile) {
+            const size_t rN = std::min(Tile, nRows - r0);
+            for (size_t r = 0; r < rN; ++r)
+                for (size_t i = 0; i < d; ++i)
+                    centered[r * d + i] = rows[(r0 + r) * d + i] - b.mean[i];
+
+            for (size_t i = 0; i < d; ++i) {
+                double* Ci = &b.C[i * d];
+                for (size_t r = 0; r < rN; ++r) {
+                    const double* x = &centered[r * d];
+                    const double xi = x[i];
+                    for (size_t j = i; j < d; ++j)
+                        Ci[j] += xi * x[j];
+                }
+            }
+        }
+
+        for (size_t i = 0; i < d; ++i)
+            for (size_t j = 0; j < i; ++j)
+                b.C[i * d + j] = b.C[j * d + i];
+
+        merge(b);
+    }
+
+    //& Chan et al. pairwise combination, exact for any split of the data.
+    void merge(const CoMoments &o) {
+        if (o.n == 0) return;
+        if (n == 0) {*this = o; return;}
+        if (o.d != d) throw std::runtime_error("CoMoments: dimension mismatch");
+
+        const auto Na = static_cast<double>(n);
+        const auto Nb = static_cast<double>(o.n);
+        const double total = Na + Nb;
+        const double w = Na * Nb / total;
+
+        std::vector<double> delta(d);
+        for (size_t i = 0; i < d; ++i) delta[i] = o.mean[i] - mean[i];
+
+        for (size_t i = 0; i < d; ++i)
+            for (size_t j = 0; j < d; ++j)
+                C[i * d + j] += o.C[i * d + j] + delta[i] * delta[j] * w;
+        for (size_t i = 0; i < d; ++i)
+            mean[i] += delta[i] * (Nb / total);
+        n += o.n;
+    }
+
+    [[nodiscard]] double Cov(const size_t i, const size_t j) const {
+        return n > 1 ? C[i * d + j] / static_cast<double>(n - 1) : 0.0;
+    }
+
+    [[nodiscard]] double Corr(const size_t i, const size_t j) const {
+        const double den = std::sqrt(C[i * d + i] * C[j * d + j]);
+        return den > 0 ? C[i * d + j] / den : 0.0;
+    }
+
+    [[nodiscard]] std::vector<double> CorrMatrix() const {
+        std::vector<double> R(d * d);
+        for (size_t i = 0; i < d; ++i)
+            for (size_t j = 0; j < d; ++j)
+                R[i * d + j] = Corr(i, j);
+        return R;
+    }
+
+    //& Solves the centered ridge normal equations (Cxx + lambda * n * I) b = Cxy for the target column,
+    //& using every other column as a regressor. Returns {coefficients, intercept, R^2}.
+    //& R^2 is 1 - SSE/Syy of the fit on the accumulated rows, SSE expanded from the co-moments.
+    [[nodiscard]] std::tuple<std::vector<double>, double, double> Ridge(const size_t target, const double lambda) const {
+        if (target >= d) throw std::runtime_error("CoMoments::Ridge: target column out of range");
+        const size_t p = d - 1;
+        std::vector<size_t> cols;
+        for (size_t i = 0; i < d; ++i) if (i != target) cols.push_back(i);
+
+        std::vector<double> A(p * p), b(p);
+        for (size_t i = 0; i < p; ++i) {
+            for (size_t j = 0; j < p; ++j)
+                A[i * p + j] = C[cols[i] * d + cols[j]];
+            A[i * p + i] += lambda * static_cast<double>(n);
+            b[i] = C[cols[i] * d + target];
+        }
+
+        //? Cholesky factorization, A is SPD for lambda > 0.
+        for (size_t j = 0; j < p; ++j) {
+            double s = A[j * p + j];
+            for (size_t k = 0; k < j; ++k) s -= A[j * p + k] * A[j * p + k];
+            if (s <= 0) throw std::runtime_error("CoMoments::Ridge: system is not positive definite");
+            A[j * p + j] = std::sqrt(s);
+            for (size_t i = j + 1; i < p; ++i) {
+                double t = A[i * p + j];
+                for (size_t k = 0; k < j; ++k) t -= A[i * p + k] * A[j * p + k];
+                A[i * p + j] = t / A[j * p + j];
+            }
+        }
+        for (size_t i = 0; i < p; ++i) {
+            double t = b[i];
+            for (size_t k = 0; k < i; ++k) t -= A[i * p + k] * b[k];
+            b[i] = t / A[i * p + i];
+        }
+        for (size_t i = p; i-- > 0;) {
+            double t = b[i];
+            for (size_t k = i + 1; k < p; ++k) t -= A[k * p + i] * b[k];
+            b[i] = t / A[i * p + i];
+        }
+
+        //? SSE = Syy - 2 b'Sxy + b'Sxx b, the shrunk b makes the two cross terms differ so neither drops out.
+        double intercept = mean[target];
+        double sse = C[target * d + target];
+        for (size_t i = 0; i < p; ++i) {
+            intercept -= b[i] * mean[cols[i]];
+            sse -= 2 * b[i] * C[cols[i] * d + target];
+            for (size_t j = 0; j < p; ++j)
+                sse += b[i] * b[j] * C[cols[i] * d + cols[j]];
+        }
+        const double syy = C[target * d + target];
+        const double r2 = syy > 0 ? 1.0 - std::max(0.0, sse) / syy : 0.0;
+        return {b, intercept, r2};
+    }
+
+    void Save(BinWriter &w) const {
+        w.val<uint64_t>(d);
+        w.val(n);
+        w.writeValue(mean);
+        w.writeValue(C);
+    }
+
+    void Load(BinReader &r) {
+        uint64_t dims;
+        r.val(dims);
+        d = dims;
+        r.val(n);
+        r.readValue(mean);
+        r.readValue(C);
+    }
+};
+
+//? Builds rows of [x_t, x_t-1, ..., x_t-lags] from a single sequence for autocorrelation via CoMoments.
+inline void LaggedRows(const std::vector<float> &seq, const size_t lags, std::vector<float> &out) {
+    out.clear();
+    if (seq.size() <= lags) return;
+    out.reserve((seq.size() - lags) * (lags + 1));
+    for (size_t t = lags; t < seq.size(); ++t)
+        for (size_t l = 0; l <= lags; ++l)
+            out.push_back(seq[t - l]);
+}
+
+//? One pass, multi-threaded reduction of CoMoments over a chunked dataset.
+//? @param next Thread-safe chunk source: fills a row-major buffer and returns the row count, 0 when exhausted.
+//? Workers accumulate locally and are merged in worker order once the source is drained.
+//? Cancelling stops every worker before its next chunk and throws JobCancelled.
+inline CoMoments ParallelCoMoments(const size_t dims,
+                                   const std::function<size_t(std::vector<float>&)> &next,
+                                   unsigned threads = std::thread::hardware_concurrency(),
+                                   const CancelToken &cancel = job::Token()) {
+    threads = std::max(1u, threads);
+    std::vector<CoMoments> partials(threads, CoMoments(dims));
+    std::vector<std::thread> workers;
+    std::mutex sourceTex;
+    std::exception_ptr failure;
+
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<float> chunk;
+            try {
+                while (true) {
+                    size_t rows;
+                    {
+                        std::lock_guard lock(sourceTex);
+                        if (failure) return;
+                        cancel.Check();
+                        rows = next(chunk);
+                    }
+                    if (rows == 0) return;
+                    partials[t].stepBlock(chunk.data(), rows);
+                }
+            } catch (...) {
+                std::lock_guard lock(sourceTex);
+                failure = std::current_exception();
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    if (failure) std::rethrow_exception(failure);
+
+    CoMoments out(dims);
+    for (const auto &p : partials) out.merge(p);
+    return out;
+}
+
+//? On-disk cache of reduced CoMoments keyed by dataset version and query, so repeated validation is free.
+struct ValidationCache {
+    explicit ValidationCache(std::filesystem::path dir) : root(std::move(dir)) {}
+
+    [[nodiscard]] std::filesystem::path PathFor(const std::string &version, const std::string &query) const {
+        return root / (version + "_" + query + ".cov");
+    }
+
+    [[nodiscard]] std::optional<CoMoments> Get(const std::string &version, const std::string &query) const {
+        const auto p = PathFor(version, query);
+        if (!std::filesystem::exists(p)) return std::nullopt;
+        try {
+            BinReader r(p.string());
+            CoMoments m;
+            m.Load(r);
+            if (!r.ok() || m.mean.size() != m.d || m.C.size() != m.d * m.d) return std::nullopt;
+            return m;
+        } catch (const std::runtime_error&) { // Truncated, corrupt or from a newer version, recomputed
+            return std::nullopt;
+        }
+    }
+
+    //& Written to a unique temporary file and committed by rename, so a crash or a concurrent validator
+    //& never leaves a partial entry behind. A failed write is dropped and recomputed next time.
+    void Put(const std::string &version, const std::string &query, const CoMoments &m) const {
+        std::error_code ec;
+        std::filesystem::create_directories(root, ec);
+        const std::string path = PathFor(version, query).string();
+        const std::string tmp = TempPath(path);
+        bool ok;
+        {
+            BinWriter w(tmp);
+            m.Save(w);
+            w.Close();
+            ok = w.ok();
+        }
+        if (!ok || !CommitFile(tmp, path)) std::filesystem::remove(tmp, ec);
+    }
+
+    template<typename F>
+    CoMoments GetOrCompute(const std::string &version, const std::string &query, F &&compute) const {
+        if (auto hit = Get(version, query)) return *hit;
+        CoMoments m = compute();
+        Put(version, query, m);
+        return m;
+    }
+
+private:
+    std::filesystem::path root;
+};
\ No newline at end of file